@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../helpers/bench.h"
+#include "../helpers/stats.h"
+#include "runner.h"
+
+int main(int argc, char **argv)
+{
+	batch_inputs_t inputs = { 0 };
+	int day = 0; // 0: infer from each path
+	int threads = 0; // 0: one per CPU
+	stats_mode_t stats = STATS_OFF;
+	int ret = 0;
+
+	// --day applies to the inputs that follow it, so days can be mixed
+	for (int arg = 1; arg < argc && ret == 0; arg++) {
+		if (strncmp(argv[arg], "--day=", 6) == 0)
+			day = atoi(argv[arg] + 6);
+		else if (strncmp(argv[arg], "--threads=", 10) == 0)
+			threads = atoi(argv[arg] + 10);
+		else if (strncmp(argv[arg], "--list=", 7) == 0)
+			ret = batch_add_list(&inputs, argv[arg] + 7, day);
+		else if (stats_parse_arg(argv[arg], &stats))
+			continue;
+		else
+			ret = batch_add(&inputs, argv[arg], day);
+	}
+
+	size_t n = batch_inputs_size(&inputs);
+	if (ret < 0 || n == 0) {
+		if (n == 0)
+			fprintf(stderr, "Usage: %s [--threads=N] [--stats[=json]] "
+					"[--day=N] [--list=FILE] FILE|DIR...\n",
+				argv[0]);
+		batch_inputs_release(&inputs);
+		return 1;
+	}
+
+	double start = bench_now();
+	size_t failed = batch_run(inputs.data, n, threads);
+	double elapsed = bench_now() - start;
+
+	for (size_t i = 0; i < n; i++) {
+		const batch_input_t *in = batch_inputs_at(&inputs, i);
+
+		if (in->status < 0)
+			printf("%s\tday-%d\terror\n", in->path, in->day);
+		else
+			printf("%s\tday-%d\t%lld\t%lld\n", in->path, in->day,
+			       in->part_one, in->part_two);
+	}
+
+	fprintf(stderr, "batch: %zu inputs (%zu failed) in %.6f s, %.1f inputs/s\n",
+		n, failed, elapsed, elapsed > 0 ? n / elapsed : 0.0);
+
+	if (stats)
+		stats_print(stats == STATS_JSON);
+
+	batch_inputs_release(&inputs);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,271 @@
+#include "runner.h"
+#include "../day-1/similarity.h"
+#include "../day-2/reports.h"
+#include "../day-3/scanner.h"
+#include "../helpers/helpers.h"
+#include "../helpers/lstream.h"
+#include "../helpers/sort.h"
+#include "../helpers/stats.h"
+#include "../helpers/vec.h"
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int batch_infer_day(const char *path)
+{
+	const char *p = path;
+
+	// The last "day-N" wins: data/day-2/day-1.input is a day-1 input
+	int day = 0;
+	while ((p = strstr(p, "day-")) != NULL) {
+		p += 4;
+		if (*p >= '1' && *p <= '3' && (p[1] < '0' || p[1] > '9'))
+			day = *p - '0';
+	}
+	return day;
+}
+
+static int batch_push(batch_inputs_t *inputs, const char *path, int day)
+{
+	batch_input_t in = { 0 };
+
+	in.day = day ? day : batch_infer_day(path);
+	if (in.day < 1 || in.day > 3) {
+		fprintf(stderr, "ERROR: No day for %s, use --day=N\n", path);
+		return -1;
+	}
+
+	in.path = strdup(path);
+	if (!in.path) {
+		fprintf(stderr, "ERROR: Failed to allocate memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	batch_inputs_push(inputs, in);
+	return 0;
+}
+
+static int compare_names(const void *a, const void *b)
+{
+	return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/// Append the regular files of a directory, sorted so runs are reproducible
+static int batch_add_dir(batch_inputs_t *inputs, const char *dir_name, int day)
+{
+	DIR *dir = opendir(dir_name);
+	if (!dir) {
+		perror("Failed to open directory");
+		return -1;
+	}
+
+	vec_t *names = vec_create(TYPE_STRING);
+	struct dirent *ent;
+	int ret = 0;
+
+	while ((ent = readdir(dir)) != NULL) {
+		if (ent->d_name[0] == '.')
+			continue;
+
+		// readdir() reuses its buffer, keep a copy of the name
+		char *name = strdup(ent->d_name);
+		if (!name) {
+			fprintf(stderr, "ERROR: Failed to allocate memory\n");
+			exit(EXIT_FAILURE);
+		}
+		vec_push_back(names, &name);
+	}
+	closedir(dir);
+
+	qsort(names->data, vec_size(names), sizeof(char *), compare_names);
+
+	for (size_t i = 0; i < vec_size(names) && ret == 0; i++) {
+		const char *name = *(char **)vec_at(names, i);
+		size_t len = strlen(dir_name) + strlen(name) + 2;
+		char *path = malloc(len);
+		struct stat sb;
+
+		if (!path) {
+			fprintf(stderr, "ERROR: Failed to allocate memory\n");
+			exit(EXIT_FAILURE);
+		}
+		snprintf(path, len, "%s/%s", dir_name, name);
+
+		if (stat(path, &sb) == 0 && S_ISREG(sb.st_mode))
+			ret = batch_push(inputs, path, day);
+		free(path);
+	}
+
+	for (size_t i = 0; i < vec_size(names); i++)
+		free(*(char **)vec_at(names, i));
+	vec_destroy(names);
+	return ret;
+}
+
+int batch_add(batch_inputs_t *inputs, const char *path, int day)
+{
+	struct stat sb;
+
+	if (stat(path, &sb) == 0 && S_ISDIR(sb.st_mode))
+		return batch_add_dir(inputs, path, day);
+
+	// Missing files are still listed, they fail when solved
+	return batch_push(inputs, path, day);
+}
+
+int batch_add_list(batch_inputs_t *inputs, const char *list_name, int day)
+{
+	lstream_t ls;
+	const char *line;
+	size_t len;
+	int ret;
+
+	if (lstream_open(list_name, 0, '\n', &ls) < 0)
+		return -1;
+
+	while ((ret = lstream_next(&ls, &line, &len)) > 0) {
+		if (len == 0)
+			continue;
+
+		char *path = strndup(line, len);
+		if (!path) {
+			fprintf(stderr, "ERROR: Failed to allocate memory\n");
+			exit(EXIT_FAILURE);
+		}
+		ret = batch_add(inputs, path, day);
+		free(path);
+		if (ret < 0)
+			break;
+	}
+
+	lstream_close(&ls);
+	return ret < 0 ? -1 : 0;
+}
+
+void batch_inputs_release(batch_inputs_t *inputs)
+{
+	for (size_t i = 0; i < batch_inputs_size(inputs); i++)
+		free(batch_inputs_at(inputs, i)->path);
+	batch_inputs_free(inputs);
+}
+
+void batch_scratch_init(batch_scratch_t *s)
+{
+	memset(&s->columns, 0, sizeof(s->columns));
+	jagged_init(&s->reports);
+}
+
+void batch_scratch_free(batch_scratch_t *s)
+{
+	columns_free(&s->columns);
+	jagged_free(&s->reports);
+}
+
+int batch_solve(batch_scratch_t *s, batch_input_t *in)
+{
+	mfile_t mf;
+
+	in->status = -1;
+	if (mfile_open(in->path, &mf) < 0)
+		return -1;
+
+	// Serial solvers: the pool already keeps every CPU busy
+	switch (in->day) {
+	case 1: {
+		columns_t *c = &s->columns;
+
+		if (columns_parse_into(mf.begin, mf.end, c) < 0)
+			goto close;
+		radix_sort_int(c->first, c->len);
+		radix_sort_int(c->second, c->len);
+		in->part_one = columns_distance(c);
+		in->part_two = similarity(c->first, c->len, c->second, c->len,
+					  SIMILARITY_MERGE);
+		break;
+	}
+	case 2: {
+		reports_tally_t t = { 0, 0 };
+
+		reports_solve_with(&s->reports, mf.begin, mf.end, &t);
+		in->part_one = t.safe;
+		in->part_two = t.safe_dampened;
+		break;
+	}
+	case 3: {
+		scanner_t sc;
+
+		scanner_init(&sc);
+		scanner_scan(&sc, mf.begin, mf.end);
+		in->part_one = sc.part_one;
+		in->part_two = sc.part_two;
+		break;
+	}
+	default:
+		goto close;
+	}
+
+	in->status = 0;
+	STATS_COUNT("inputs", 1);
+
+close:
+	mfile_close(&mf);
+	return in->status;
+}
+
+/// Shared by the workers of one batch_run()
+typedef struct {
+	batch_input_t *inputs;
+	size_t n;
+	size_t next; // Next input to hand out, taken with an atomic add
+	size_t failed;
+} batch_pool_t;
+
+static void *batch_worker(void *arg)
+{
+	batch_pool_t *pool = arg;
+	batch_scratch_t s;
+	size_t i;
+
+	batch_scratch_init(&s);
+
+	while ((i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) <
+	       pool->n) {
+		if (batch_solve(&s, &pool->inputs[i]) < 0)
+			__atomic_fetch_add(&pool->failed, 1, __ATOMIC_RELAXED);
+	}
+
+	batch_scratch_free(&s);
+	return NULL;
+}
+
+size_t batch_run(batch_input_t *inputs, size_t n, int threads)
+{
+	batch_pool_t pool = { inputs, n, 0, 0 };
+
+	if (threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if ((size_t)threads > n)
+		threads = n ? (int)n : 1;
+
+	pthread_t *tids = malloc(sizeof(*tids) * threads);
+	int started = 0;
+
+	// The calling thread is a worker too
+	for (; tids && started < threads - 1; started++) {
+		if (pthread_create(&tids[started], NULL, batch_worker, &pool) !=
+		    0)
+			break;
+	}
+
+	batch_worker(&pool);
+
+	for (int i = 0; i < started; i++)
+		pthread_join(tids[i], NULL);
+
+	free(tids);
+	return pool.failed;
+}
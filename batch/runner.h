@@ -0,0 +1,98 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include <stddef.h> // For size_t
+#include "../day-1/columns.h"
+#include "../helpers/jagged.h"
+#include "../helpers/tvec.h"
+
+/// One input file and, once solved, its answers
+typedef struct {
+	char *path; // Owned copy of the file name
+	int day; // Puzzle the file is an input for, 1 to 3
+	int status; // 0 once solved, -1 if it could not be read
+	long long part_one; // First half answer
+	long long part_two; // Second half answer
+} batch_input_t;
+
+TVEC_DEFINE(batch_inputs, batch_input_t)
+
+/// Buffers a worker keeps from one input to the next
+typedef struct {
+	columns_t columns; // Day-1 columns
+	jagged_t reports; // Day-2 parsed reports
+} batch_scratch_t;
+
+/**
+ * Guesses the day of an input from a "day-N" component in its path.
+ *
+ * @param path The file name.
+ * @return The day, or 0 if the path does not name one.
+ */
+int batch_infer_day(const char *path);
+
+/**
+ * Appends one input. A directory appends every regular file inside it that
+ * does not start with a dot, in name order.
+ *
+ * @param inputs The list to append to.
+ * @param path File or directory name.
+ * @param day Day of the input(s), 0 to infer it from each path.
+ * @return 0 on success, -1 if the path cannot be read or has no day.
+ */
+int batch_add(batch_inputs_t *inputs, const char *path, int day);
+
+/**
+ * Appends every path listed in a file, one per line, see batch_add().
+ *
+ * @param inputs The list to append to.
+ * @param list_name The list file, or NULL / "-" for stdin.
+ * @param day Day of the inputs, 0 to infer it from each path.
+ * @return 0 on success, -1 on failure.
+ */
+int batch_add_list(batch_inputs_t *inputs, const char *list_name, int day);
+
+/**
+ * Frees the list and the paths it owns.
+ *
+ * @param inputs The list.
+ */
+void batch_inputs_release(batch_inputs_t *inputs);
+
+/**
+ * Initializes a worker's buffers.
+ *
+ * @param s The buffers.
+ */
+void batch_scratch_init(batch_scratch_t *s);
+
+/**
+ * Frees a worker's buffers.
+ *
+ * @param s The buffers.
+ */
+void batch_scratch_free(batch_scratch_t *s);
+
+/**
+ * Solves one input with the serial day solver, refilling the worker's
+ * buffers instead of allocating new ones. Sets in->status and the answers.
+ *
+ * @param s The worker's buffers.
+ * @param in The input.
+ * @return 0 on success, -1 on failure.
+ */
+int batch_solve(batch_scratch_t *s, batch_input_t *in);
+
+/**
+ * Solves every input on a pool of threads. Each worker takes the next
+ * unsolved input until none are left, so long and short inputs balance out;
+ * results land in the inputs themselves, in their original order.
+ *
+ * @param inputs The inputs.
+ * @param n Number of inputs.
+ * @param threads Number of workers, 0 for one per CPU.
+ * @return Number of inputs that failed.
+ */
+size_t batch_run(batch_input_t *inputs, size_t n, int threads);
+
+#endif // RUNNER_H
@@ -0,0 +1,90 @@
+#include "runner.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+void test_infer_day(void)
+{
+	assert(batch_infer_day("../day-1/data.input") == 1);
+	assert(batch_infer_day("day-3") == 3);
+	assert(batch_infer_day("inputs/day-2/day-1.txt") == 1);
+	assert(batch_infer_day("day-12/data.input") == 0);
+	assert(batch_infer_day("data.input") == 0);
+	printf("test_infer_day passed.\n");
+}
+
+void test_add(void)
+{
+	batch_inputs_t inputs = { 0 };
+
+	assert(batch_add(&inputs, "../day-2/data.input", 0) == 0);
+	assert(batch_add(&inputs, "data.input", 3) == 0);
+	assert(batch_add(&inputs, "data.input", 0) == -1);
+	assert(batch_inputs_size(&inputs) == 2);
+	assert(batch_inputs_at(&inputs, 0)->day == 2);
+	assert(batch_inputs_at(&inputs, 1)->day == 3);
+
+	// Every file of the directory, in name order, dot files skipped
+	assert(batch_add(&inputs, "../day-3", 0) == 0);
+	for (size_t i = 3; i < batch_inputs_size(&inputs); i++) {
+		const batch_input_t *prev = batch_inputs_at(&inputs, i - 1);
+		const batch_input_t *in = batch_inputs_at(&inputs, i);
+		assert(strcmp(prev->path, in->path) < 0);
+		assert(in->day == 3);
+	}
+
+	batch_inputs_release(&inputs);
+	printf("test_add passed.\n");
+}
+
+/// Answers of the checked-in inputs, as printed by the day binaries
+static const struct {
+	const char *path;
+	long long part_one;
+	long long part_two;
+} expected[] = {
+	{ "../day-1/data.input", 2769675, 24643097 },
+	{ "../day-1/data.test", 11, 31 },
+	{ "../day-2/data.input", 269, 337 },
+	{ "../day-2/data.test", 2, 4 },
+	{ "../day-3/data.input", 175615763, 74361272 },
+	{ "../day-3/test.input", 105, 83 },
+};
+
+#define N_EXPECTED (sizeof(expected) / sizeof(expected[0]))
+
+void test_run(int threads)
+{
+	batch_inputs_t inputs = { 0 };
+
+	// Several rounds so every worker refills its buffers more than once
+	for (int round = 0; round < 8; round++)
+		for (size_t i = 0; i < N_EXPECTED; i++)
+			assert(batch_add(&inputs, expected[i].path, 0) == 0);
+	assert(batch_add(&inputs, "missing.input", 1) == 0);
+
+	size_t n = batch_inputs_size(&inputs);
+	assert(batch_run(inputs.data, n, threads) == 1);
+
+	for (size_t i = 0; i + 1 < n; i++) {
+		const batch_input_t *in = batch_inputs_at(&inputs, i);
+		assert(in->status == 0);
+		assert(in->part_one == expected[i % N_EXPECTED].part_one);
+		assert(in->part_two == expected[i % N_EXPECTED].part_two);
+	}
+	assert(batch_inputs_at(&inputs, n - 1)->status == -1);
+
+	batch_inputs_release(&inputs);
+	printf("test_run(%d) passed.\n", threads);
+}
+
+int main(void)
+{
+	test_infer_day();
+	test_add();
+	test_run(1);
+	test_run(4);
+	printf("All tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,186 @@
+#include "columns.h"
+#include "../helpers/helpers.h"
+#include "../helpers/lstream.h"
+#include "../helpers/sort.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/// One column to sort on its own thread
+typedef struct {
+	int *col;
+	int len;
+	int threads;
+} sort_job_t;
+
+static void *sort_column(void *arg)
+{
+	sort_job_t *job = arg;
+	radix_sort_int_mt(job->col, job->len, job->threads);
+	return NULL;
+}
+
+void columns_sort(columns_t *c)
+{
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int threads = cpus > 2 ? (int)(cpus / 2) : 1;
+	sort_job_t jobs[2] = { { c->first, c->len, threads },
+			       { c->second, c->len, threads } };
+	pthread_t tid;
+
+	if (pthread_create(&tid, NULL, sort_column, &jobs[1]) != 0) {
+		sort_column(&jobs[0]);
+		sort_column(&jobs[1]);
+		return;
+	}
+
+	sort_column(&jobs[0]);
+	pthread_join(tid, NULL);
+}
+
+/// Parse one "a   b" line; returns 1 if both columns were found
+static int parse_pair(const char *line, const char *eol, int *a, int *b)
+{
+	const char *cur = scan_int(line, eol, a);
+	return cur && scan_int(cur, eol, b);
+}
+
+int columns_parse(const char *begin, const char *end, columns_t *c)
+{
+	memset(c, 0, sizeof(*c));
+	return columns_parse_into(begin, end, c);
+}
+
+int columns_parse_into(const char *begin, const char *end, columns_t *c)
+{
+	int lines = count_lines(begin, end);
+
+	c->len = 0;
+	if (lines > c->cap || !c->first) {
+		int cap = lines ? lines : 1;
+
+		columns_free(c);
+		c->first = (int *)malloc(sizeof(int) * cap);
+		c->second = (int *)malloc(sizeof(int) * cap);
+		if (!c->first || !c->second) {
+			perror("Failed to allocate memory");
+			columns_free(c);
+			return -1;
+		}
+		c->cap = cap;
+	}
+
+	const char *line = begin;
+
+	while (line < end && c->len < lines) {
+		const char *eol = memchr(line, '\n', end - line);
+		if (!eol)
+			eol = end;
+
+		// split a<space><space><space>b
+		if (parse_pair(line, eol, &c->first[c->len],
+			       &c->second[c->len]))
+			c->len++;
+
+		line = eol + 1;
+	}
+
+	return 0;
+}
+
+int columns_load(const char *f_name, columns_t *c)
+{
+	mfile_t mf;
+
+	if (mfile_open(f_name, &mf) < 0)
+		return -1;
+
+	int ret = columns_parse(mf.begin, mf.end, c);
+	mfile_close(&mf);
+	return ret;
+}
+
+int columns_load_stream(const char *f_name, columns_t *c)
+{
+	lstream_t ls;
+	const char *line;
+	size_t len;
+	int cap = 1024;
+	int ret = 0;
+
+	if (lstream_open(f_name, 0, '\n', &ls) < 0)
+		return -1;
+
+	c->len = 0;
+	c->first = (int *)malloc(sizeof(int) * cap);
+	c->second = (int *)malloc(sizeof(int) * cap);
+	int oom = !c->first || !c->second;
+
+	while (!oom && (ret = lstream_next(&ls, &line, &len)) > 0) {
+		if (c->len == cap) {
+			cap *= 2;
+			int *first = realloc(c->first, sizeof(int) * cap);
+			if (first)
+				c->first = first;
+			int *second = realloc(c->second, sizeof(int) * cap);
+			if (second)
+				c->second = second;
+			oom = !first || !second;
+			if (oom)
+				break;
+		}
+
+		if (parse_pair(line, line + len, &c->first[c->len],
+			       &c->second[c->len]))
+			c->len++;
+	}
+
+	lstream_close(&ls);
+
+	if (oom)
+		perror("Failed to allocate memory");
+
+	if (oom || ret < 0) {
+		columns_free(c);
+		return -1;
+	}
+
+	c->cap = cap;
+	return 0;
+}
+
+void columns_free(columns_t *c)
+{
+	free(c->first);
+	free(c->second);
+	c->first = c->second = NULL;
+	c->len = c->cap = 0;
+}
+
+long long columns_distance(const columns_t *c)
+{
+	long long sum = 0;
+
+	for (int i = 0; i < c->len; i++)
+		sum += llabs((long long)c->first[i] - c->second[i]);
+
+	return sum;
+}
+
+int columns_solve(const char *begin, const char *end, similarity_t how,
+		  long long *distance, long long *score)
+{
+	columns_t c;
+
+	if (columns_parse(begin, end, &c) < 0)
+		return -1;
+
+	columns_sort(&c);
+	*distance = columns_distance(&c);
+	*score = similarity(c.first, c.len, c.second, c.len, how);
+
+	columns_free(&c);
+	return 0;
+}
@@ -0,0 +1,93 @@
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include "similarity.h"
+
+/// The two location id columns of a day-1 input
+typedef struct {
+	int *first; // Left column
+	int *second; // Right column
+	int len; // Number of pairs in each column
+	int cap; // Allocated slots in each column
+} columns_t;
+
+/**
+ * Parses "a   b" pairs from an in-memory input. Both columns are sized up
+ * front from the line count, so parsing never reallocates. Lines without
+ * two numbers are skipped.
+ *
+ * @param begin First byte of the input.
+ * @param end One past the last byte of the input.
+ * @param c Set to the parsed columns, release with columns_free().
+ * @return 0 on success, -1 on failure.
+ */
+int columns_parse(const char *begin, const char *end, columns_t *c);
+
+/**
+ * Same as columns_parse(), reusing the columns already held by c and only
+ * growing them when the input has more lines than they can hold, so one
+ * columns_t can be refilled input after input.
+ *
+ * @param begin First byte of the input.
+ * @param end One past the last byte of the input.
+ * @param c Zeroed or previously parsed columns, release with columns_free().
+ * @return 0 on success, -1 on failure (c is then freed).
+ */
+int columns_parse_into(const char *begin, const char *end, columns_t *c);
+
+/**
+ * Same as columns_parse(), on a mapped file.
+ *
+ * @param f_name The name of the file to read, or NULL / "-" for stdin.
+ * @param c Set to the parsed columns, release with columns_free().
+ * @return 0 on success, -1 on failure.
+ */
+int columns_load(const char *f_name, columns_t *c);
+
+/**
+ * Same as columns_load(), reading through the streaming reader and growing
+ * the columns as lines arrive, so the raw input never has to fit in memory.
+ *
+ * @param f_name The name of the file to read, or NULL / "-" for stdin.
+ * @param c Set to the parsed columns, release with columns_free().
+ * @return 0 on success, -1 on failure.
+ */
+int columns_load_stream(const char *f_name, columns_t *c);
+
+/**
+ * Frees both columns.
+ *
+ * @param c The columns to release.
+ */
+void columns_free(columns_t *c);
+
+/**
+ * Sorts both columns ascending at the same time, splitting the CPUs
+ * between them.
+ *
+ * @param c The columns to sort.
+ */
+void columns_sort(columns_t *c);
+
+/**
+ * Total distance: the sum of |first[i] - second[i]| over sorted columns.
+ *
+ * @param c Sorted columns.
+ * @return The total distance.
+ */
+long long columns_distance(const columns_t *c);
+
+/**
+ * Solves both halves for an in-memory input.
+ *
+ * @param begin First byte of the input.
+ * @param end One past the last byte of the input.
+ * @param how Similarity engine to use.
+ * @param distance Set to the first half answer.
+ * @param score Set to the second half answer.
+ * @return 0 on success, -1 on failure.
+ */
+int columns_solve(const char *begin, const char *end, similarity_t how,
+		  long long *distance, long long *score);
+
+#endif // COLUMNS_H
@@ -0,0 +1,65 @@
+#include "columns.h"
+#include "../helpers/bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/// One timed solve and its answers
+typedef struct {
+	const char *input;
+	size_t len;
+	similarity_t how;
+	long long distance;
+	long long score;
+} columns_job_t;
+
+static void run_solve(void *arg)
+{
+	columns_job_t *job = arg;
+
+	if (columns_solve(job->input, job->input + job->len, job->how,
+			  &job->distance, &job->score) < 0)
+		exit(EXIT_FAILURE);
+}
+
+static void run_parse(void *arg)
+{
+	columns_job_t *job = arg;
+	columns_t c;
+
+	if (columns_parse(job->input, job->input + job->len, &c) < 0)
+		exit(EXIT_FAILURE);
+	job->distance = c.len;
+	columns_free(&c);
+}
+
+int main(int argc, char **argv)
+{
+	size_t lines = argc > 1 ? strtoul(argv[1], NULL, 10) :
+				  bench_scaled(10000000);
+	columns_job_t job = { 0 };
+	char *input = bench_gen_day1(lines, 42, &job.len);
+
+	job.input = input;
+
+	bench_run("day1/parse", job.len, run_parse, &job);
+	if ((size_t)job.distance != lines) {
+		fprintf(stderr, "ERROR: parsed %lld of %zu lines\n",
+			job.distance, lines);
+		return 1;
+	}
+
+	job.how = SIMILARITY_MERGE;
+	bench_run("day1/solve/merge", job.len, run_solve, &job);
+	long long distance = job.distance, score = job.score;
+
+	job.how = SIMILARITY_HASH;
+	bench_run("day1/solve/hash", job.len, run_solve, &job);
+	if (job.distance != distance || job.score != score) {
+		fprintf(stderr, "ERROR: hash gave %lld/%lld, merge %lld/%lld\n",
+			job.distance, job.score, distance, score);
+		return 1;
+	}
+
+	free(input);
+	return 0;
+}
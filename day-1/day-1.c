@@ -1,85 +1,133 @@
-#include <stddef.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 #include "../helpers/helpers.h"
+#include "../helpers/rcache.h"
+#include "../helpers/stats.h"
+#include "columns.h"
+#include "incr.h"
 
-int compare(const void *a, const void *b)
-{
-	return (*(int *)a - *(int *)b);
-}
+/// Milliseconds between checks for new lines with --follow
+#define FOLLOW_POLL_MS 200
 
-int count_occurances(int *a, int file_length, int key)
+static int print_totals(const incr_t *e, void *arg)
 {
-	int count = 0;
-	for (int i = 0; i < file_length; i++) {
-		if (a[i] == key)
-			count++;
-	}
-	return count;
+	(void)arg;
+	printf("sum1 = %lld\n", e->distance);
+	printf("sum2 = %lld\n", e->score);
+	fflush(stdout);
+	return 0;
 }
 
-int main()
+int main(int argc, char **argv)
 {
-	char *fcontent = NULL;
-
 	const char *file_name = "./data.input";
-	read_file(file_name, &fcontent);
-	if (!fcontent) {
-		fprintf(stderr, "Error reading %s file", file_name);
-		return 1;
+	int use_stream = 0;
+	int follow = 0;
+	rcache_opts_t cache_opts = { 0 };
+	int use_cache;
+	stats_mode_t stats = STATS_OFF;
+	similarity_t how = SIMILARITY_MERGE;
+
+	for (int arg = 1; arg < argc; arg++) {
+		if (strcmp(argv[arg], "--stream") == 0) {
+			use_stream = 1;
+		} else if (strcmp(argv[arg], "--follow") == 0) {
+			follow = 1;
+		} else if (strcmp(argv[arg], "--similarity=merge") == 0) {
+			how = SIMILARITY_MERGE;
+		} else if (strcmp(argv[arg], "--similarity=hash") == 0) {
+			how = SIMILARITY_HASH;
+		} else if (strcmp(argv[arg], "--similarity=naive") == 0) {
+			how = SIMILARITY_NAIVE;
+		} else if (stats_parse_arg(argv[arg], &stats)) {
+			continue;
+		} else if (rcache_parse_arg(argv[arg], &cache_opts)) {
+			continue;
+		} else {
+			file_name = argv[arg];
+		}
 	}
 
-	int file_length = count_str_lines(fcontent);
-
-	int *first = (int *)malloc(sizeof(int) * file_length);
-	int *second = (int *)malloc(sizeof(int) * file_length);
-
-	int i = 0;
-	char *token;
-
-	while ((token = strsep(&fcontent, "\n"))) {
-		if (strlen(token) == 0)
-			continue;
+	// Keep the totals up to date as lines are appended, until interrupted
+	if (follow) {
+		incr_t e;
+
+		incr_init(&e);
+		int ret = incr_follow(&e, file_name, FOLLOW_POLL_MS, print_totals,
+				      NULL);
+		incr_free(&e);
+		if (stats)
+			stats_print(stats == STATS_JSON);
+		return ret < 0 ? 1 : 0;
+	}
 
-		// split a<space><space><space>b
-		char *token1 = strtok(token, " ");
-		char *token2 = strtok(NULL, " ");
+	columns_t c;
+	mfile_t mf;
+	rcache_t cache;
+	rcache_key_t key;
+	long long answers[2]; // Distance, similarity score
+	int ret;
 
-		first[i] = atoi(token1);
-		second[i] = atoi(token2);
+	use_cache = rcache_open_solver(&cache, &cache_opts, RCACHE_DAY1,
+				       use_stream);
+	if (use_cache < 0)
+		return 1;
 
-		i++;
+	{
+		STATS_SCOPE("load");
+		ret = use_stream ? columns_load_stream(file_name, &c) :
+				   mfile_open(file_name, &mf);
+	}
+	if (ret < 0) {
+		fprintf(stderr, "Error reading %s file", file_name);
+		return 1;
 	}
 
-	qsort(first, file_length, sizeof(first[0]), compare);
-	qsort(second, file_length, sizeof(second[0]), compare);
+	if (!use_stream) {
+		if (use_cache) {
+			key = rcache_key(RCACHE_DAY1, mf.begin, mf.end);
+			if (rcache_get(&cache, &key, answers, 2)) {
+				mfile_close(&mf);
+				goto print;
+			}
+		}
+
+		{
+			STATS_SCOPE("parse");
+			ret = columns_parse(mf.begin, mf.end, &c);
+		}
+		mfile_close(&mf);
+		if (ret < 0)
+			return 1;
+	}
+	STATS_COUNT("pairs", c.len);
 
-	i = 0;
-	int sum = 0;
-	while (i < file_length) {
-		/* printf("%d %d\n", first[i], second[i]); */
-		int tmp = (int)(first[i] - second[i]);
-		sum += abs(tmp);
-		i++;
+	{
+		STATS_SCOPE("sort");
+		columns_sort(&c);
+	}
+	{
+		STATS_SCOPE("distance");
+		answers[0] = columns_distance(&c);
 	}
+	{
+		STATS_SCOPE("similarity");
+		answers[1] = similarity(c.first, c.len, c.second, c.len, how);
+	}
+	columns_free(&c);
 
-	printf("sum1 = %d\n", sum);
+	if (use_cache)
+		rcache_put(&cache, &key, answers, 2);
 
-	i = 0;
-	sum = 0;
-	while (i < file_length) {
-		int key = first[i];
-		int count = count_occurances(second, file_length, key);
-		sum = sum + (count * key);
-		i++;
-	}
+print:
+	printf("sum1 = %lld\n", answers[0]);
+	printf("sum2 = %lld\n", answers[1]);
 
-	printf("sum2 = %d\n", sum);
+	if (use_cache)
+		rcache_close(&cache);
 
-	free(fcontent);
-	free(first);
-	free(second);
+	if (stats)
+		stats_print(stats == STATS_JSON);
 
 	return 0;
 }
@@ -0,0 +1,523 @@
+#include "incr.h"
+#include "columns.h"
+#include "../helpers/helpers.h"
+#include "../helpers/sort.h"
+#include "../helpers/stats.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Runs per block; a full block is split in two
+#define INCR_BLOCK_MAX 512
+
+/// Bytes read at a time by incr_follow()
+#define INCR_READ_CHUNK (64 * 1024)
+
+/// First batch size from which incr_add_lines() bulk loads
+#define INCR_LOAD_MIN (64 * 1024)
+
+static void *incr_alloc(size_t size)
+{
+	void *p = malloc(size);
+	if (!p) {
+		fprintf(stderr, "ERROR: Failed to allocate memory\n");
+		exit(EXIT_FAILURE);
+	}
+	return p;
+}
+
+void incr_init(incr_t *e)
+{
+	memset(e, 0, sizeof(*e));
+	hcount_init(&e->left, 0);
+	hcount_init(&e->right, 0);
+}
+
+void incr_free(incr_t *e)
+{
+	if (!e)
+		return;
+
+	for (size_t i = 0; i < e->n_blocks; i++) {
+		free(e->blocks[i].segs);
+		free(e->blocks[i].order);
+		free(e->blocks[i].sorted_d);
+		free(e->blocks[i].below);
+	}
+	free(e->blocks);
+	hcount_free(&e->left);
+	hcount_free(&e->right);
+	memset(e, 0, sizeof(*e));
+}
+
+/// Refresh sorted_d and below from order, after d or width changed
+static void incr_block_sums(incr_block_t *b)
+{
+	b->below[0] = 0;
+	for (size_t i = 0; i < b->len; i++) {
+		const incr_seg_t *seg = &b->segs[b->order[i]];
+		b->sorted_d[i] = seg->d;
+		b->below[i + 1] = b->below[i] + seg->width;
+	}
+}
+
+static const incr_seg_t *incr_sort_segs; // Runs being sorted by incr_block_index()
+
+static int compare_order(const void *a, const void *b)
+{
+	int x = incr_sort_segs[*(const uint16_t *)a].d;
+	int y = incr_sort_segs[*(const uint16_t *)b].d;
+	return (x > y) - (x < y);
+}
+
+/// Sort a freshly filled block from scratch
+static void incr_block_index(incr_block_t *b)
+{
+	for (size_t i = 0; i < b->len; i++)
+		b->order[i] = (uint16_t)i;
+	incr_sort_segs = b->segs;
+	qsort(b->order, b->len, sizeof(*b->order), compare_order);
+	incr_block_sums(b);
+}
+
+/// Index of the first sorted d that is >= x (or > x with `after`)
+static size_t incr_block_bound(const incr_block_t *b, int x, int after)
+{
+	size_t lo = 0, hi = b->len;
+
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (b->sorted_d[mid] < x || (after && b->sorted_d[mid] == x))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/// Width of the block's runs where D is negative (sign < 0) or positive
+static long long incr_block_width(const incr_block_t *b, int sign)
+{
+	// D = d + add, so D < 0 means d < -add
+	if (sign < 0)
+		return b->below[incr_block_bound(b, -b->add, 0)];
+	return b->below[b->len] - b->below[incr_block_bound(b, -b->add, 1)];
+}
+
+/// Runs [first, last) all moved by the same amount: they and the others
+/// are each still in order, so merging the two keeps the index sorted
+static void incr_block_reorder(incr_block_t *b, size_t first, size_t last)
+{
+	uint16_t moved[INCR_BLOCK_MAX], kept[INCR_BLOCK_MAX];
+	size_t n_moved = 0, n_kept = 0;
+
+	for (size_t i = 0; i < b->len; i++) {
+		uint16_t idx = b->order[i];
+		if (idx >= first && idx < last)
+			moved[n_moved++] = idx;
+		else
+			kept[n_kept++] = idx;
+	}
+
+	size_t i = 0, j = 0, k = 0;
+	while (i < n_moved && j < n_kept)
+		b->order[k++] = b->segs[moved[i]].d <= b->segs[kept[j]].d ?
+					moved[i++] :
+					kept[j++];
+	while (i < n_moved)
+		b->order[k++] = moved[i++];
+	while (j < n_kept)
+		b->order[k++] = kept[j++];
+
+	incr_block_sums(b);
+}
+
+/// Index a run just inserted at `at`, the others shifted up by one
+static void incr_block_insert_order(incr_block_t *b, size_t at)
+{
+	int d = b->segs[at].d;
+	size_t pos = b->len - 1; // Slots used before the insertion
+
+	for (size_t i = 0; i < b->len - 1; i++) {
+		if (b->order[i] >= at)
+			b->order[i]++;
+		if (pos == b->len - 1 && b->segs[b->order[i]].d >= d)
+			pos = i;
+	}
+
+	memmove(&b->order[pos + 1], &b->order[pos],
+		sizeof(*b->order) * (b->len - 1 - pos));
+	b->order[pos] = (uint16_t)at;
+	incr_block_sums(b);
+}
+
+/// Open an empty block at position `at`
+static incr_block_t *incr_block_insert(incr_t *e, size_t at)
+{
+	if (e->n_blocks == e->cap_blocks) {
+		size_t cap = e->cap_blocks ? e->cap_blocks * 2 : 16;
+		incr_block_t *blocks = realloc(e->blocks, sizeof(*blocks) * cap);
+		if (!blocks) {
+			fprintf(stderr, "ERROR: Failed to allocate memory\n");
+			exit(EXIT_FAILURE);
+		}
+		e->blocks = blocks;
+		e->cap_blocks = cap;
+	}
+
+	memmove(&e->blocks[at + 1], &e->blocks[at],
+		sizeof(*e->blocks) * (e->n_blocks - at));
+	e->n_blocks++;
+
+	incr_block_t *b = &e->blocks[at];
+	b->segs = incr_alloc(sizeof(*b->segs) * INCR_BLOCK_MAX);
+	b->order = incr_alloc(sizeof(*b->order) * INCR_BLOCK_MAX);
+	b->sorted_d = incr_alloc(sizeof(*b->sorted_d) * INCR_BLOCK_MAX);
+	b->below = incr_alloc(sizeof(*b->below) * (INCR_BLOCK_MAX + 1));
+	b->len = 0;
+	b->add = 0;
+	return b;
+}
+
+/// Move the upper half of a full block into a new block after it
+static void incr_block_split(incr_t *e, size_t bi)
+{
+	incr_block_t *next = incr_block_insert(e, bi + 1);
+	incr_block_t *b = &e->blocks[bi];
+	size_t half = b->len / 2;
+
+	memcpy(next->segs, b->segs + half,
+	       sizeof(*b->segs) * (b->len - half));
+	next->len = b->len - half;
+	next->add = b->add;
+
+	// Each half keeps its runs in the order they already had
+	size_t k = 0, k_next = 0;
+	for (size_t i = 0; i < b->len; i++) {
+		uint16_t idx = b->order[i];
+		if (idx < half)
+			b->order[k++] = idx;
+		else
+			next->order[k_next++] = (uint16_t)(idx - half);
+	}
+	b->len = half;
+
+	incr_block_sums(b);
+	incr_block_sums(next);
+}
+
+/// Block holding the last run that starts at or before v, 0 if none does
+static size_t incr_find_block(const incr_t *e, int v)
+{
+	size_t lo = 0, hi = e->n_blocks;
+
+	while (hi - lo > 1) {
+		size_t mid = (lo + hi) / 2;
+		if (e->blocks[mid].segs[0].start <= v)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/// Number of runs of b that start at or before v
+static size_t incr_find_seg(const incr_block_t *b, int v)
+{
+	size_t lo = 0, hi = b->len;
+
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (b->segs[mid].start <= v)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/// Number of runs of b that start before v
+static size_t incr_find_seg_before(const incr_block_t *b, int v)
+{
+	size_t lo = 0, hi = b->len;
+
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (b->segs[mid].start < v)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/// Make v the start of a run, splitting the run that covers it
+static void incr_split_at(incr_t *e, int v)
+{
+	if (e->n_blocks == 0) {
+		incr_block_t *b = incr_block_insert(e, 0);
+		b->segs[0] = (incr_seg_t){ v, 0, 0 };
+		b->len = 1;
+		incr_block_index(b);
+		return;
+	}
+
+	size_t bi = incr_find_block(e, v);
+	incr_block_t *b = &e->blocks[bi];
+	size_t at = incr_find_seg(b, v);
+	incr_seg_t seg;
+
+	if (at > 0) {
+		incr_seg_t *prev = &b->segs[at - 1];
+		if (prev->start == v)
+			return;
+
+		// Same D as the run it is cut from; the largest run has width 0
+		seg.start = v;
+		seg.d = prev->d;
+		seg.width = prev->width ? prev->start + prev->width - v : 0;
+		prev->width = (long long)v - prev->start;
+	} else {
+		// Below every seen value both columns count 0
+		seg.start = v;
+		seg.d = -b->add;
+		seg.width = (long long)b->segs[0].start - v;
+	}
+
+	memmove(&b->segs[at + 1], &b->segs[at],
+		sizeof(*b->segs) * (b->len - at));
+	b->segs[at] = seg;
+	b->len++;
+	incr_block_insert_order(b, at);
+
+	if (b->len == INCR_BLOCK_MAX)
+		incr_block_split(e, bi);
+}
+
+/// Add s to D over [lo, hi), both run starts; returns the distance change
+static long long incr_shift(incr_t *e, int lo, int hi, int s)
+{
+	long long opposite = 0; // Width where |D| shrinks
+
+	for (size_t bi = incr_find_block(e, lo); bi < e->n_blocks; bi++) {
+		incr_block_t *b = &e->blocks[bi];
+
+		if (b->segs[0].start >= hi)
+			break;
+
+		if (b->segs[0].start >= lo && b->segs[b->len - 1].start < hi) {
+			// Whole block: count from the index, defer the add
+			opposite += incr_block_width(b, -s);
+			b->add += s;
+			continue;
+		}
+
+		size_t first = incr_find_seg_before(b, lo), last = first;
+		for (; last < b->len && b->segs[last].start < hi; last++) {
+			incr_seg_t *seg = &b->segs[last];
+			int d = seg->d + b->add;
+
+			if ((s > 0 && d < 0) || (s < 0 && d > 0))
+				opposite += seg->width;
+			seg->d += s;
+		}
+		incr_block_reorder(b, first, last);
+	}
+
+	return ((long long)hi - lo) - 2 * opposite;
+}
+
+void incr_add(incr_t *e, int a, int b)
+{
+	// A new left value matches every right one seen so far and vice
+	// versa; a == b within the pair is counted once, on the right
+	e->score += (long long)a * hcount_get(&e->right, a);
+	hcount_add(&e->left, a, 1);
+	e->score += (long long)b * hcount_get(&e->left, b);
+	hcount_add(&e->right, b, 1);
+
+	if (a != b) {
+		incr_split_at(e, a);
+		incr_split_at(e, b);
+		if (a < b)
+			e->distance += incr_shift(e, a, b, 1);
+		else
+			e->distance += incr_shift(e, b, a, -1);
+	}
+
+	e->pairs++;
+}
+
+/// Append a run after every other one, filling blocks half way so later
+/// splits stay rare
+static void incr_push_run(incr_t *e, int start, int d)
+{
+	incr_block_t *b = e->n_blocks ? &e->blocks[e->n_blocks - 1] : NULL;
+
+	if (b) {
+		incr_seg_t *prev = &b->segs[b->len - 1];
+		prev->width = (long long)start - prev->start;
+	}
+
+	if (!b || b->len == INCR_BLOCK_MAX / 2)
+		b = incr_block_insert(e, e->n_blocks);
+
+	b->segs[b->len++] = (incr_seg_t){ start, d, 0 };
+}
+
+/// Fill an empty engine from whole columns: sort once, then walk both in
+/// step to lay out the runs, O(n log n) instead of n single adds
+static int incr_load(incr_t *e, const char *begin, const char *end)
+{
+	columns_t c;
+
+	if (columns_parse(begin, end, &c) < 0)
+		return -1;
+
+	radix_sort_int(c.first, c.len);
+	radix_sort_int(c.second, c.len);
+	e->distance = columns_distance(&c);
+	e->score = similarity(c.first, c.len, c.second, c.len,
+			      SIMILARITY_MERGE);
+	e->pairs = c.len;
+
+	int i = 0, j = 0, d = 0;
+	while (i < c.len || j < c.len) {
+		int v = j == c.len || (i < c.len && c.first[i] < c.second[j]) ?
+				c.first[i] :
+				c.second[j];
+
+		for (; i < c.len && c.first[i] == v; i++, d++)
+			hcount_add(&e->left, v, 1);
+		for (; j < c.len && c.second[j] == v; j++, d--)
+			hcount_add(&e->right, v, 1);
+		incr_push_run(e, v, d);
+	}
+
+	for (size_t k = 0; k < e->n_blocks; k++)
+		incr_block_index(&e->blocks[k]);
+
+	STATS_COUNT("pairs", c.len);
+	columns_free(&c);
+	return 0;
+}
+
+/// Add every line of [begin, end), the last one may lack its newline
+static void incr_add_range(incr_t *e, const char *begin, const char *end)
+{
+	const char *line = begin;
+	long long before = e->pairs;
+	int a, b;
+
+	while (line < end) {
+		const char *eol = memchr(line, '\n', end - line);
+		if (!eol)
+			eol = end;
+
+		const char *cur = scan_int(line, eol, &a);
+		if (cur && scan_int(cur, eol, &b))
+			incr_add(e, a, b);
+
+		line = eol + 1;
+	}
+
+	STATS_COUNT("pairs", e->pairs - before);
+}
+
+size_t incr_add_lines(incr_t *e, const char *begin, const char *end)
+{
+	const char *last = end;
+
+	while (last > begin && last[-1] != '\n')
+		last--;
+
+	if (e->pairs == 0 && last - begin >= INCR_LOAD_MIN &&
+	    incr_load(e, begin, last) == 0)
+		return last - begin;
+
+	incr_add_range(e, begin, last);
+	return last - begin;
+}
+
+int incr_follow(incr_t *e, const char *f_name, int poll_ms,
+		incr_update_fn on_update, void *arg)
+{
+	int use_stdin = (f_name == NULL || strcmp(f_name, "-") == 0);
+	int fd = use_stdin ? STDIN_FILENO : open(f_name, O_RDONLY);
+	struct stat sb;
+	int ret = 0;
+
+	if (fd < 0) {
+		perror("Failed to read file");
+		return -1;
+	}
+
+	// Only a named regular file is waited on; stdin ends at its end even
+	// when redirected from a file
+	int can_grow = !use_stdin && poll_ms > 0 && fstat(fd, &sb) == 0 &&
+		       S_ISREG(sb.st_mode);
+	struct timespec pause = { poll_ms / 1000, (poll_ms % 1000) * 1000000L };
+
+	// Room for what a regular file already holds, so it is bulk loaded
+	size_t cap = INCR_READ_CHUNK, held = 0;
+	if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) &&
+	    (size_t)sb.st_size >= cap)
+		cap = (size_t)sb.st_size + 1;
+	char *buf = incr_alloc(cap);
+
+	for (;;) {
+		if (held == cap) { // One line longer than the buffer
+			char *bigger = realloc(buf, cap * 2);
+			if (!bigger) {
+				perror("Failed to allocate memory");
+				ret = -1;
+				break;
+			}
+			buf = bigger;
+			cap *= 2;
+		}
+
+		ssize_t n = read(fd, buf + held, cap - held);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("Failed to read file");
+			ret = -1;
+			break;
+		}
+
+		long long before = e->pairs;
+
+		if (n == 0) {
+			if (can_grow) {
+				nanosleep(&pause, NULL);
+				continue;
+			}
+
+			// The input ended, a held partial line is the last one
+			incr_add_range(e, buf, buf + held);
+			if (e->pairs != before && on_update)
+				on_update(e, arg);
+			break;
+		}
+
+		STATS_COUNT("bytes_read", n);
+		held += n;
+		size_t used = incr_add_lines(e, buf, buf + held);
+		memmove(buf, buf + used, held - used);
+		held -= used;
+
+		if (e->pairs != before && on_update && on_update(e, arg))
+			break;
+	}
+
+	free(buf);
+	if (!use_stdin)
+		close(fd);
+	return ret;
+}
@@ -0,0 +1,103 @@
+#ifndef INCR_H
+#define INCR_H
+
+#include <stddef.h> // For size_t
+#include <stdint.h>
+#include "../helpers/hcount.h"
+
+/// A run of values [start, start + width) over which D stays the same
+typedef struct {
+	int start; // A value seen in either column
+	int d; // D on the run, without the pending add of its block
+	long long width; // Up to the next seen value, 0 for the largest one
+} incr_seg_t;
+
+/// Consecutive runs, with an index for counting widths by the sign of D
+typedef struct {
+	incr_seg_t *segs; // Runs, by ascending start
+	size_t len; // Number of runs
+	int add; // Pending add for every run of the block
+	uint16_t *order; // Run indices by ascending d, patched in O(len)
+	int *sorted_d; // d of the runs in that order
+	long long *below; // below[i]: total width of sorted_d[0, i)
+} incr_block_t;
+
+/**
+ * Running day-1 totals over a growing list of pairs.
+ *
+ * Both columns are kept as their difference of cumulative counts:
+ * D(t) = #{left <= t} - #{right <= t}. For equal sized columns the sum of
+ * |left[i] - right[i]| over the sorted columns equals the sum of |D(t)|
+ * over every integer t, and a new pair (a, b) only adds +1 or -1 to D
+ * between a and b. The distance therefore changes by the width of that
+ * range minus twice the width where D had the opposite sign, which the
+ * blocks answer without touching the other pairs. The similarity score
+ * follows from a value -> count map per column.
+ */
+typedef struct {
+	incr_block_t *blocks; // Runs of every seen value, by ascending start
+	size_t n_blocks;
+	size_t cap_blocks;
+	hcount_t left; // Value -> count, left column
+	hcount_t right; // Value -> count, right column
+	long long pairs; // Pairs added
+	long long distance; // Sum of |left[i] - right[i]|, sorted columns
+	long long score; // Similarity score
+} incr_t;
+
+/**
+ * Initializes an engine with no pairs.
+ *
+ * @param e Pointer to the engine.
+ */
+void incr_init(incr_t *e);
+
+/**
+ * Frees the memory associated with an engine.
+ *
+ * @param e Pointer to the engine.
+ */
+void incr_free(incr_t *e);
+
+/**
+ * Adds one pair and updates both totals, in O(sqrt(distinct values)).
+ *
+ * @param e Pointer to the engine.
+ * @param a Left column value.
+ * @param b Right column value.
+ */
+void incr_add(incr_t *e, int a, int b);
+
+/**
+ * Adds the "a   b" pairs of every complete line in [begin, end). Lines
+ * without two numbers are skipped, as in columns_parse(). A large first
+ * batch is sorted and laid out in one go instead of pair by pair.
+ *
+ * @param e Pointer to the engine.
+ * @param begin First byte of the text.
+ * @param end One past the last byte of the text.
+ * @return Number of bytes consumed: up to and including the last newline.
+ */
+size_t incr_add_lines(incr_t *e, const char *begin, const char *end);
+
+/// Called by incr_follow() after new pairs were added; non-zero stops it
+typedef int (*incr_update_fn)(const incr_t *e, void *arg);
+
+/**
+ * Adds the pairs of a file and keeps following it as it grows, like
+ * `tail -f`. A last line without a newline is held back until it is
+ * complete, or until the input ends.
+ *
+ * @param e Pointer to the engine.
+ * @param f_name The file, or NULL / "-" for stdin.
+ * @param poll_ms How long to wait for more data at the end of a named
+ *                regular file; 0 stops there instead. Stdin and pipes are
+ *                read until they end.
+ * @param on_update Called after each read that added pairs, may be NULL.
+ * @param arg Passed to on_update.
+ * @return 0 when the input ended or on_update asked to stop, -1 on error.
+ */
+int incr_follow(incr_t *e, const char *f_name, int poll_ms,
+		incr_update_fn on_update, void *arg);
+
+#endif // INCR_H
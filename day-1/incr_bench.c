@@ -0,0 +1,75 @@
+#include "incr.h"
+#include "columns.h"
+#include "../helpers/bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/// A full recompute over the same pairs, what an update costs without incr
+typedef struct {
+	const char *input;
+	size_t len;
+	long long distance;
+	long long score;
+} recompute_job_t;
+
+static void run_recompute(void *arg)
+{
+	recompute_job_t *job = arg;
+
+	if (columns_solve(job->input, job->input + job->len, SIMILARITY_MERGE,
+			  &job->distance, &job->score) < 0)
+		exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv)
+{
+	size_t lines = argc > 1 ? strtoul(argv[1], NULL, 10) :
+				  bench_scaled(1000000);
+	size_t appends = argc > 2 ? strtoul(argv[2], NULL, 10) :
+				    bench_scaled(100000);
+	recompute_job_t job = { 0 };
+	const size_t line_len = 14; // bench_gen_day1() lines are fixed size
+	incr_t e;
+
+	if (appends == 0) {
+		fprintf(stderr, "ERROR: Need at least one append to time\n");
+		return 1;
+	}
+
+	char *input = bench_gen_day1(lines + appends, 42, &job.len);
+
+	// The existing log, loaded in one go
+	incr_init(&e);
+	double t0 = bench_now();
+	incr_add_lines(&e, input, input + lines * line_len);
+	bench_report("day1_incr/load", lines * line_len, bench_now() - t0);
+
+	// Then one line at a time, as a follower would see them
+	double *samples = malloc(sizeof(double) * appends);
+	if (!samples) {
+		fprintf(stderr, "ERROR: Failed to allocate samples\n");
+		return 1;
+	}
+	for (size_t i = 0; i < appends; i++) {
+		const char *line = input + (lines + i) * line_len;
+		double start = bench_now();
+		incr_add_lines(&e, line, line + line_len);
+		samples[i] = bench_now() - start;
+	}
+	bench_report_samples("day1_incr/append", line_len, samples, appends);
+	bench_note("%-28s %zu appends after %zu pairs, worst %.2f us",
+		   "day1_incr", appends, lines, samples[appends - 1] * 1e6);
+
+	job.input = input;
+	bench_run("day1_incr/recompute", job.len, run_recompute, &job);
+	if (job.distance != e.distance || job.score != e.score) {
+		fprintf(stderr, "ERROR: incremental %lld/%lld, recomputed %lld/%lld\n",
+			e.distance, e.score, job.distance, job.score);
+		return 1;
+	}
+
+	free(samples);
+	incr_free(&e);
+	free(input);
+	return 0;
+}
@@ -0,0 +1,144 @@
+#include "incr.h"
+#include "columns.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+
+/// Append `count` random pairs to text as lines
+static size_t gen_lines(char *text, size_t count, int range, unsigned seed)
+{
+	size_t len = 0;
+
+	srand(seed);
+	for (size_t i = 0; i < count; i++)
+		len += sprintf(text + len, "%d   %d\n", rand() % range - range / 4,
+			       rand() % range - range / 4);
+	return len;
+}
+
+/// Totals recomputed from scratch on text[0, len)
+static void check_against_solve(const incr_t *e, const char *text, size_t len)
+{
+	long long distance, score;
+
+	assert(columns_solve(text, text + len, SIMILARITY_MERGE, &distance,
+			     &score) == 0);
+	assert(e->distance == distance);
+	assert(e->score == score);
+}
+
+void test_sample(void)
+{
+	const char text[] = "3   4\n4   3\n2   5\n1   3\n3   9\n3   3\n";
+	incr_t e;
+
+	incr_init(&e);
+	assert(incr_add_lines(&e, text, text + sizeof(text) - 1) ==
+	       sizeof(text) - 1);
+	assert(e.pairs == 6);
+	assert(e.distance == 11);
+	assert(e.score == 31);
+	incr_free(&e);
+	printf("test_sample passed.\n");
+}
+
+void test_matches_recompute(void)
+{
+	// Small and wide value ranges: many repeats, then many block splits
+	static const int ranges[] = { 10, 1000, 100000 };
+	char *text = malloc(30 * 4000);
+
+	for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+		size_t len = gen_lines(text, 4000, ranges[r], 11 + r);
+		incr_t e;
+
+		// Feed it in uneven pieces and check after each one
+		incr_init(&e);
+		size_t done = 0;
+		for (size_t cut = 0; cut < len; cut += 1237) {
+			size_t end = cut + 1237 < len ? cut + 1237 : len;
+			done += incr_add_lines(&e, text + done, text + end);
+			check_against_solve(&e, text, done);
+		}
+		assert(done == len && e.pairs == 4000);
+		incr_free(&e);
+	}
+
+	free(text);
+	printf("test_matches_recompute passed.\n");
+}
+
+void test_bulk_then_append(void)
+{
+	char *text = malloc(30 * 20000);
+	size_t len = gen_lines(text, 20000, 100000, 5);
+	size_t half = len / 2;
+	incr_t e;
+
+	// A first batch this large is sorted in one go, the rest added one
+	// line at a time on top of it
+	while (text[half - 1] != '\n')
+		half--;
+
+	incr_init(&e);
+	assert(incr_add_lines(&e, text, text + half) == half);
+	check_against_solve(&e, text, half);
+
+	size_t done = half;
+	while (done < len) {
+		const char *eol = memchr(text + done, '\n', len - done);
+		done += incr_add_lines(&e, text + done, eol + 1);
+		if (done % 64 == 0)
+			check_against_solve(&e, text, done);
+	}
+	check_against_solve(&e, text, len);
+	assert(e.pairs == 20000);
+
+	incr_free(&e);
+	free(text);
+	printf("test_bulk_then_append passed.\n");
+}
+
+static int count_updates(const incr_t *e, void *arg)
+{
+	(void)e;
+	++*(int *)arg;
+	return 0;
+}
+
+void test_follow(void)
+{
+	char path[] = "/tmp/incr_tests.XXXXXX";
+	const char text[] = "3   4\n4   3\n2   5\n1   3\n3   9\n3   3"; // No final \n
+	int updates = 0;
+	incr_t e;
+
+	int fd = mkstemp(path);
+	assert(fd >= 0);
+	assert(write(fd, text, sizeof(text) - 1) == (ssize_t)(sizeof(text) - 1));
+	close(fd);
+
+	// poll_ms 0: stop at the end of the file, taking the unfinished line
+	incr_init(&e);
+	assert(incr_follow(&e, path, 0, count_updates, &updates) == 0);
+	assert(updates >= 1);
+	assert(e.pairs == 6 && e.distance == 11 && e.score == 31);
+	incr_free(&e);
+
+	assert(incr_follow(&e, "/nonexistent/incr", 0, NULL, NULL) == -1);
+
+	unlink(path);
+	printf("test_follow passed.\n");
+}
+
+int main(void)
+{
+	test_sample();
+	test_matches_recompute();
+	test_bulk_then_append();
+	test_follow();
+	printf("All tests passed.\n");
+	return 0;
+}
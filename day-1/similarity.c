@@ -0,0 +1,85 @@
+#include "similarity.h"
+#include "../helpers/hcount.h"
+
+int count_occurances(int *a, int file_length, int key)
+{
+	int count = 0;
+	for (int i = 0; i < file_length; i++) {
+		if (a[i] == key)
+			count++;
+	}
+	return count;
+}
+
+/// Both columns sorted: walk them together and multiply matching run lengths
+static long long similarity_merge(const int *first, int n_first,
+				  const int *second, int n_second)
+{
+	long long sum = 0;
+	int i = 0, j = 0;
+
+	while (i < n_first && j < n_second) {
+		if (first[i] < second[j]) {
+			i++;
+		} else if (first[i] > second[j]) {
+			j++;
+		} else {
+			int key = first[i];
+			long long run_first = 0, run_second = 0;
+
+			while (i < n_first && first[i] == key) {
+				run_first++;
+				i++;
+			}
+			while (j < n_second && second[j] == key) {
+				run_second++;
+				j++;
+			}
+
+			sum += (long long)key * run_first * run_second;
+		}
+	}
+
+	return sum;
+}
+
+/// Any order: count the second column once, then look every value up
+static long long similarity_hash(const int *first, int n_first,
+				 const int *second, int n_second)
+{
+	hcount_t counts;
+	long long sum = 0;
+
+	// Columns repeat heavily, let the table grow to the distinct count
+	// instead of sizing it for n_second keys
+	hcount_init(&counts, 0);
+	for (int j = 0; j < n_second; j++)
+		hcount_add(&counts, second[j], 1);
+
+	for (int i = 0; i < n_first; i++)
+		sum += (long long)first[i] * hcount_get(&counts, first[i]);
+
+	hcount_free(&counts);
+	return sum;
+}
+
+long long similarity(const int *first, int n_first, const int *second,
+		     int n_second, similarity_t how)
+{
+	long long sum = 0;
+
+	switch (how) {
+	case SIMILARITY_MERGE:
+		return similarity_merge(first, n_first, second, n_second);
+	case SIMILARITY_HASH:
+		return similarity_hash(first, n_first, second, n_second);
+	case SIMILARITY_NAIVE:
+		for (int i = 0; i < n_first; i++)
+			sum += (long long)first[i] *
+			       count_occurances((int *)second, n_second,
+						first[i]);
+		return sum;
+	}
+
+	return sum;
+}
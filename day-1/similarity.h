@@ -0,0 +1,36 @@
+#ifndef SIMILARITY_H
+#define SIMILARITY_H
+
+/// Ways of computing the similarity score
+typedef enum {
+	SIMILARITY_MERGE, // Linear merge over two sorted columns
+	SIMILARITY_HASH, // Count map over the second column, any order
+	SIMILARITY_NAIVE // Rescan the second column for every value, O(n^2)
+} similarity_t;
+
+/**
+ * Counts how often key occurs in a.
+ *
+ * @param a Column to scan.
+ * @param file_length Number of values in a.
+ * @param key Value to count.
+ * @return Number of occurrences of key.
+ */
+int count_occurances(int *a, int file_length, int key);
+
+/**
+ * Similarity score: the sum of every value in first multiplied by the number
+ * of times it appears in second.
+ *
+ * @param first First column.
+ * @param n_first Number of values in first.
+ * @param second Second column.
+ * @param n_second Number of values in second.
+ * @param how Which engine to use. SIMILARITY_MERGE requires both columns
+ *            sorted ascending, the others accept any order.
+ * @return The similarity score.
+ */
+long long similarity(const int *first, int n_first, const int *second,
+		     int n_second, similarity_t how);
+
+#endif // SIMILARITY_H
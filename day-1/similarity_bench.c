@@ -0,0 +1,106 @@
+#include "similarity.h"
+#include "../helpers/bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAIVE_MAX 10000 // The quadratic engine, timed repeatedly, stops here
+
+/// One engine on one pair of columns, and its answer
+typedef struct {
+	const int *first;
+	const int *second;
+	int n;
+	similarity_t how;
+	long long score;
+} similarity_job_t;
+
+static void run_similarity(void *arg)
+{
+	similarity_job_t *job = arg;
+
+	job->score = similarity(job->first, job->n, job->second, job->n,
+				job->how);
+}
+
+static int compare_int(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+	return (x > y) - (x < y);
+}
+
+/// Time one engine at size n and check it agrees with the merge answer
+static int bench_engine(similarity_job_t *job, const char *engine,
+			long long expected)
+{
+	char name[64];
+
+	snprintf(name, sizeof(name), "similarity/%s/n=%d", engine, job->n);
+	bench_run(name, 2 * sizeof(int) * job->n, run_similarity, job);
+	if (expected >= 0 && job->score != expected) {
+		fprintf(stderr, "ERROR: %s %lld != merge %lld at n=%d\n",
+			engine, job->score, expected, job->n);
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	// Rows from 10^3 up to max_rows by powers of 10, 10^8 needs ~1.6GB
+	size_t max_rows = argc > 1 ? strtoul(argv[1], NULL, 10) :
+				     bench_scaled(10000000);
+	unsigned state = 42;
+	size_t n = max_rows < 1000 ? max_rows : 1000;
+
+	for (;;) {
+		int *first = malloc(sizeof(int) * n);
+		int *second = malloc(sizeof(int) * n);
+		int *first_sorted = malloc(sizeof(int) * n);
+		int *second_sorted = malloc(sizeof(int) * n);
+		if (!first || !second || !first_sorted || !second_sorted) {
+			fprintf(stderr, "ERROR: Failed to allocate %zu rows\n",
+				n);
+			return 1;
+		}
+
+		// Same value range as the real puzzle input: lots of repeats at scale
+		for (size_t i = 0; i < n; i++) {
+			first[i] = 10000 + bench_rand(&state) % 90000;
+			second[i] = 10000 + bench_rand(&state) % 90000;
+		}
+
+		memcpy(first_sorted, first, sizeof(int) * n);
+		memcpy(second_sorted, second, sizeof(int) * n);
+		qsort(first_sorted, n, sizeof(int), compare_int);
+		qsort(second_sorted, n, sizeof(int), compare_int);
+
+		similarity_job_t job = { first_sorted, second_sorted, (int)n,
+					 SIMILARITY_MERGE, 0 };
+		bench_engine(&job, "merge", -1);
+		long long merge = job.score;
+
+		job.first = first;
+		job.second = second;
+		job.how = SIMILARITY_HASH;
+		if (bench_engine(&job, "hash", merge) < 0)
+			return 1;
+
+		if (n <= NAIVE_MAX) {
+			job.how = SIMILARITY_NAIVE;
+			if (bench_engine(&job, "naive", merge) < 0)
+				return 1;
+		}
+
+		free(first);
+		free(second);
+		free(first_sorted);
+		free(second_sorted);
+
+		if (n >= max_rows)
+			break;
+		n = n * 10 < max_rows ? n * 10 : max_rows;
+	}
+
+	return 0;
+}
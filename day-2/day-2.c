@@ -1,152 +1,94 @@
 #include "../helpers/helpers.h"
+#include "../helpers/rcache.h"
+#include "../helpers/stats.h"
 #include "../helpers/vec.h"
-#include <ctype.h>
-#include <string.h>
+#include "reports.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/cdefs.h>
+#include <string.h>
 
-int issafe(vec_t *levels)
+int main(int argc, char **argv)
 {
-	if (vec_size(levels) < 2)
-		return 0;
-
-	int *first = (int *)vec_at(levels, 0);
-	int *second = (int *)vec_at(levels, 1);
-	/* printf("First: %d, Second: %d\n", *first, *second); */
-	int increasing = (*second > *first);
-
-	for (size_t i = 1; i < vec_size(levels); ++i) {
-		int *cur = (int *)vec_at(levels, i);
-		int *prev = (int *)vec_at(levels, i - 1);
-
-		int abs_diff = abs(*cur - *prev);
+	const char *f_name = "data.input";
+	int use_stream = 0;
+	int threads = 1;
+	rcache_opts_t cache_opts = { 0 };
+	int use_cache;
+	stats_mode_t stats = STATS_OFF;
+	reports_tally_t t = { 0, 0 };
+	mfile_t mf;
+	rcache_t cache;
+	rcache_key_t key;
+	long long answers[2]; // Safe, safe with the dampener
+	int ret = 0;
 
-		if (abs_diff < 1 || abs_diff > 3 ||
-		    (*cur > *prev) != increasing) {
-			/* printf("ERROR: %d %d %d\n", *prev, *cur, abs_diff); */
-			return 0;
-		}
+	for (int arg = 1; arg < argc; arg++) {
+		if (strcmp(argv[arg], "--stream") == 0)
+			use_stream = 1;
+		else if (strncmp(argv[arg], "--threads=", 10) == 0)
+			threads = atoi(argv[arg] + 10); // 0: one per CPU
+		else if (stats_parse_arg(argv[arg], &stats))
+			continue;
+		else if (rcache_parse_arg(argv[arg], &cache_opts))
+			continue;
+		else
+			f_name = argv[arg];
 	}
 
-	return 1;
-}
-
-int issafe_with_dampener(vec_t *levels)
-{
-	for (size_t i = 0; i < vec_size(levels); ++i) {
-		vec_t *modified = vec_create(TYPE_INT);
-
-		for (size_t j = 0; j < vec_size(levels); ++j) {
-			if (j != i) {
-				int value = *(int *)vec_at(levels, j);
-
-				vec_push_back(modified, &value);
-			}
-		}
+	use_cache = rcache_open_solver(&cache, &cache_opts, RCACHE_DAY2,
+				       use_stream);
+	if (use_cache < 0)
+		return 1;
 
-		if (issafe(modified)) {
-			vec_destroy(modified);
+	if (use_stream) {
+		STATS_SCOPE("solve_stream");
+		if (reports_solve_stream(f_name, &t) < 0)
 			return 1;
+	} else {
+		{
+			STATS_SCOPE("load");
+			ret = mfile_open(f_name, &mf);
 		}
-
-		vec_destroy(modified);
-	}
-
-	return 0;
-}
-
-void solve_second_half(char *f_content)
-{
-	int num_safe = 0;
-	/* vec_t *vec = vec_create(TYPE_VEC); */
-
-	char *content = strdup(f_content);
-	if (!content) {
-		perror("ERROR: Failed to allocate memory for content copy");
-		return;
-	}
-
-	char *line = content;
-	while ((line = strsep(&content, "\n")) != NULL) {
-		if (strlen(line) == 0)
-			continue;
-
-		vec_t *levels = vec_create(TYPE_INT);
-
-		char *tok = strsep(&line, " ");
-		while (tok) {
-			if (strlen(tok) == 0)
-				continue;
-
-			int num = atoi(tok);
-			vec_push_back(levels, &num);
-
-			tok = strsep(&line, " ");
+		if (ret < 0) {
+			perror("Failed to read file");
+			return 1;
 		}
 
-		if (issafe(levels) || issafe_with_dampener(levels))
-			num_safe++;
-		/* vec_push_back(vec, levels); */
-	}
-
-	/* vec_print(vec); */
-
-	printf("Safes: %d\n", num_safe);
-
-	/* vec_destroy(vec); */
-}
-
-void solve_first_half(char *f_content)
-{
-	int num_safe = 0;
-
-	char *content = strdup(f_content);
-	if (!content) {
-		perror("ERROR: Failed to allocate memory for content copy");
-		return;
-	}
-
-	char *line = content;
-	while ((line = strsep(&content, "\n")) != NULL) {
-		if (strlen(line) == 0)
-			continue;
-
-		vec_t *levels = vec_create(TYPE_INT);
-
-		char *tok = strsep(&line, " ");
-		while (tok) {
-			if (isdigit(tok[0]) ||
-			    (tok[0] == '-' && isdigit(tok[1]))) {
-				int num = atoi(tok);
-				vec_push_back(levels, &num);
+		if (use_cache) {
+			key = rcache_key(RCACHE_DAY2, mf.begin, mf.end);
+			if (rcache_get(&cache, &key, answers, 2)) {
+				mfile_close(&mf);
+				t.safe = (int)answers[0];
+				t.safe_dampened = (int)answers[1];
+				goto print;
 			}
+		}
 
-			tok = strsep(&line, " ");
+		{
+			STATS_SCOPE("solve");
+			ret = reports_solve_parallel(mf.begin, mf.end, threads,
+						     &t);
 		}
+		mfile_close(&mf);
+		if (ret < 0)
+			return 1;
 
-		if (issafe(levels))
-			num_safe++;
+		if (use_cache) {
+			answers[0] = t.safe;
+			answers[1] = t.safe_dampened;
+			rcache_put(&cache, &key, answers, 2);
+		}
 	}
 
-	printf("Safes: %d\n", num_safe);
-}
-
-int main(void)
-{
-	char *f_content = NULL;
-	int ret = 0;
-
-	ret = read_file("data.input", &f_content);
-	if (ret < 0) {
-		perror("Failed to read file");
-		return 1;
-	}
+print:
+	printf("Safes: %d\n", t.safe);
+	printf("Safes: %d\n", t.safe_dampened);
 
-	solve_first_half(f_content);
-	solve_second_half(f_content);
+	if (use_cache)
+		rcache_close(&cache);
 
-	free(f_content);
+	if (stats)
+		stats_print(stats == STATS_JSON);
 
 	return 0;
 }
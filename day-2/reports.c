@@ -0,0 +1,344 @@
+#include "reports.h"
+#include "safety.h"
+#include "../helpers/helpers.h"
+#include "../helpers/lstream.h"
+#include "../helpers/stats.h"
+#include "../helpers/tvec.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+int issafe(vec_t *levels)
+{
+	if (vec_size(levels) < 2)
+		return 0;
+
+	int *first = (int *)vec_at(levels, 0);
+	int *second = (int *)vec_at(levels, 1);
+	/* printf("First: %d, Second: %d\n", *first, *second); */
+	int increasing = (*second > *first);
+
+	for (size_t i = 1; i < vec_size(levels); ++i) {
+		int *cur = (int *)vec_at(levels, i);
+		int *prev = (int *)vec_at(levels, i - 1);
+
+		int abs_diff = abs(*cur - *prev);
+
+		if (abs_diff < 1 || abs_diff > 3 ||
+		    (*cur > *prev) != increasing) {
+			/* printf("ERROR: %d %d %d\n", *prev, *cur, abs_diff); */
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+int issafe_with_dampener_naive(vec_t *levels)
+{
+	size_t n = vec_size(levels);
+	const int *data = levels->data;
+	vec_t *modified = vec_create_with_capacity(TYPE_INT, n);
+	int safe = 0;
+
+	for (size_t i = 0; i < n && !safe; ++i) {
+		// Everything but level i, as two bulk copies into reused storage
+		vec_clear(modified);
+		vec_push_n(modified, data, i);
+		vec_push_n(modified, data + i + 1, n - i - 1);
+
+		safe = issafe(modified);
+	}
+
+	vec_destroy(modified);
+	return safe;
+}
+
+/// Index of the level that breaks the rules when `skip` is left out,
+/// or n if the remaining levels are safe
+static size_t levels_first_bad(const int *levels, size_t n, size_t skip)
+{
+	int have_prev = 0, have_dir = 0;
+	int prev = 0, increasing = 0;
+
+	for (size_t i = 0; i < n; i++) {
+		if (i == skip)
+			continue;
+
+		int cur = levels[i];
+		if (have_prev) {
+			if (!have_dir) {
+				increasing = (cur > prev);
+				have_dir = 1;
+			}
+
+			int abs_diff = abs(cur - prev);
+			if (abs_diff < 1 || abs_diff > 3 ||
+			    (cur > prev) != increasing)
+				return i;
+		}
+
+		prev = cur;
+		have_prev = 1;
+	}
+
+	return n;
+}
+
+int levels_safe(const int *levels, size_t n, size_t skip)
+{
+	size_t count = n - (skip < n);
+
+	if (count < 2)
+		return 0;
+
+	return levels_first_bad(levels, n, skip) == n;
+}
+
+int levels_safe_dampened(const int *levels, size_t n)
+{
+	if (n < 3) // Dropping a level leaves fewer than two
+		return 0;
+
+	size_t bad = levels_first_bad(levels, n, n);
+	if (bad == n) // Already safe, dropping the last level keeps it so
+		return 1;
+
+	// The first bad pair is (bad - 1, bad). Dropping any level after it
+	// leaves that pair in place, and dropping one before it only helps
+	// if it changes the direction, which is set by levels 0 and 1.
+	if (levels_safe(levels, n, bad) || levels_safe(levels, n, bad - 1))
+		return 1;
+
+	return levels_safe(levels, n, 0) || levels_safe(levels, n, 1);
+}
+
+int issafe_with_dampener(vec_t *levels)
+{
+	return levels_safe_dampened((const int *)levels->data,
+				    vec_size(levels));
+}
+
+/// Parse one report line [line, eol) into levels, reusing its storage
+static void parse_levels(const char *line, const char *eol, ivec_t *levels)
+{
+	int num;
+
+	// Every level takes a digit and a separator, so this bounds the count
+	// and the pushes below never reallocate
+	ivec_clear(levels);
+	ivec_reserve(levels, (eol - line) / 2 + 1);
+	while ((line = scan_int(line, eol, &num)) != NULL)
+		ivec_push(levels, num);
+}
+
+void reports_tally_one(reports_tally_t *t, const int *levels, size_t n)
+{
+	if (n == 0)
+		return;
+
+	if (levels_safe(levels, n, n)) {
+		t->safe++;
+		t->safe_dampened++;
+	} else if (levels_safe_dampened(levels, n)) {
+		t->safe_dampened++;
+	}
+}
+
+void reports_tally_rows(const jagged_t *reports, size_t first, size_t last,
+			reports_tally_t *t)
+{
+	safety_tally_rows(reports, first, last, t);
+}
+
+/// Input bytes parsed per batch, small enough for the rows to stay in cache
+#define REPORTS_BATCH (64 * 1024)
+
+/// Parse a batch of lines into one flat array, evaluate it, reuse the array
+void reports_solve_with(jagged_t *reports, const char *begin, const char *end,
+			reports_tally_t *t)
+{
+	while (begin < end) {
+		const char *cut = end;
+
+		if (end - begin > REPORTS_BATCH) {
+			cut = memchr(begin + REPORTS_BATCH, '\n',
+				     end - begin - REPORTS_BATCH);
+			cut = cut ? cut + 1 : end;
+		}
+
+		jagged_clear(reports);
+		{
+			STATS_SCOPE("parse");
+			jagged_parse_ints(reports, begin, cut);
+		}
+		{
+			STATS_SCOPE("evaluate");
+			reports_tally_rows(reports, 0, jagged_rows(reports), t);
+		}
+		STATS_COUNT("reports", jagged_rows(reports));
+		STATS_COUNT("levels", ivec_size(&reports->values));
+		begin = cut;
+	}
+}
+
+void reports_solve(const char *begin, const char *end, reports_tally_t *t)
+{
+	jagged_t reports;
+
+	jagged_init(&reports);
+	reports_solve_with(&reports, begin, end, t);
+	jagged_free(&reports);
+}
+
+/// Work for one thread: a slice of raw input, or a range of parsed reports
+typedef struct {
+	const char *begin;
+	const char *end;
+	const jagged_t *reports; // Non-NULL for a row range
+	size_t first;
+	size_t last;
+	reports_tally_t tally;
+} reports_job_t;
+
+static void *reports_worker(void *arg)
+{
+	reports_job_t *job = arg;
+
+	if (job->reports)
+		reports_tally_rows(job->reports, job->first, job->last,
+				   &job->tally);
+	else
+		reports_solve(job->begin, job->end, &job->tally);
+	return NULL;
+}
+
+/// Run one job per thread and add up their tallies
+static int reports_run_jobs(reports_job_t *jobs, int threads,
+			    reports_tally_t *t)
+{
+	pthread_t *tids = malloc(sizeof(*tids) * threads);
+	if (!tids) {
+		perror("ERROR: Failed to allocate worker state");
+		return -1;
+	}
+
+	int started = 0;
+	for (; started < threads; started++) {
+		if (pthread_create(&tids[started], NULL, reports_worker,
+				   &jobs[started]) != 0)
+			break;
+	}
+
+	// If the system ran out of threads, finish the remaining jobs here
+	for (int i = started; i < threads; i++)
+		reports_worker(&jobs[i]);
+
+	for (int i = 0; i < threads; i++) {
+		if (i < started)
+			pthread_join(tids[i], NULL);
+		t->safe += jobs[i].tally.safe;
+		t->safe_dampened += jobs[i].tally.safe_dampened;
+	}
+
+	free(tids);
+	return 0;
+}
+
+/// Reports are independent: cut the input on line boundaries, one slice per thread
+int reports_solve_parallel(const char *begin, const char *end, int threads,
+			   reports_tally_t *t)
+{
+	if (threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (threads <= 1 || end - begin < threads) {
+		reports_solve(begin, end, t);
+		return 0;
+	}
+
+	reports_job_t *jobs = calloc(threads, sizeof(*jobs));
+	if (!jobs) {
+		perror("ERROR: Failed to allocate worker state");
+		return -1;
+	}
+
+	const char *cut = begin;
+	for (int i = 0; i < threads; i++) {
+		const char *next = begin + (end - begin) * (i + 1) / threads;
+
+		// Move the cut past the end of the line it landed in
+		if (i == threads - 1) {
+			next = end;
+		} else if (next > cut) {
+			const char *eol = memchr(next - 1, '\n', end - next + 1);
+			next = eol ? eol + 1 : end;
+		} else {
+			next = cut;
+		}
+
+		jobs[i].begin = cut;
+		jobs[i].end = next;
+		cut = next;
+	}
+
+	int ret = reports_run_jobs(jobs, threads, t);
+	free(jobs);
+	return ret;
+}
+
+/// Parsed rows need no boundary search, split them evenly by count
+int reports_tally_parallel(const jagged_t *reports, int threads,
+			   reports_tally_t *t)
+{
+	size_t rows = jagged_rows(reports);
+
+	if (threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (threads <= 1 || rows < (size_t)threads) {
+		reports_tally_rows(reports, 0, rows, t);
+		return 0;
+	}
+
+	reports_job_t *jobs = calloc(threads, sizeof(*jobs));
+	if (!jobs) {
+		perror("ERROR: Failed to allocate worker state");
+		return -1;
+	}
+
+	for (int i = 0; i < threads; i++) {
+		jobs[i].reports = reports;
+		jobs[i].first = rows * i / threads;
+		jobs[i].last = rows * (i + 1) / threads;
+	}
+
+	int ret = reports_run_jobs(jobs, threads, t);
+	free(jobs);
+	return ret;
+}
+
+/// One report at a time off the streaming reader
+int reports_solve_stream(const char *f_name, reports_tally_t *t)
+{
+	lstream_t ls;
+	const char *line;
+	size_t len;
+	int ret;
+
+	if (lstream_open(f_name, 0, '\n', &ls) < 0)
+		return -1;
+
+	ivec_t levels = { 0 };
+
+	while ((ret = lstream_next(&ls, &line, &len)) > 0) {
+		parse_levels(line, line + len, &levels);
+		reports_tally_one(t, levels.data, ivec_size(&levels));
+	}
+
+	ivec_free(&levels);
+	lstream_close(&ls);
+	return ret < 0 ? -1 : 0;
+}
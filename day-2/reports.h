@@ -0,0 +1,145 @@
+#ifndef REPORTS_H
+#define REPORTS_H
+
+#include <stddef.h> // For size_t
+#include "../helpers/jagged.h"
+#include "../helpers/vec.h"
+
+/**
+ * Checks whether a report is safe: at least two levels, all increasing or
+ * all decreasing, and adjacent levels differ by 1 to 3.
+ *
+ * @param levels Vector of TYPE_INT levels.
+ * @return 1 if safe, 0 otherwise.
+ */
+int issafe(vec_t *levels);
+
+/**
+ * Checks whether a report becomes safe after removing exactly one level.
+ * Works directly on the vector's storage, without allocating.
+ *
+ * @param levels Vector of TYPE_INT levels.
+ * @return 1 if some single removal makes the report safe, 0 otherwise.
+ */
+int issafe_with_dampener(vec_t *levels);
+
+/**
+ * Reference version of issafe_with_dampener() that rebuilds the report
+ * without each level in turn and checks it with issafe(). Kept for
+ * differential testing.
+ *
+ * @param levels Vector of TYPE_INT levels.
+ * @return 1 if some single removal makes the report safe, 0 otherwise.
+ */
+int issafe_with_dampener_naive(vec_t *levels);
+
+/**
+ * Same rules as issafe(), on a plain array with one level optionally skipped.
+ *
+ * @param levels Array of levels.
+ * @param n Number of levels.
+ * @param skip Index of the level to leave out, or n (or more) to keep all.
+ * @return 1 if the remaining levels are safe, 0 otherwise.
+ */
+int levels_safe(const int *levels, size_t n, size_t skip);
+
+/**
+ * Same as issafe_with_dampener(), on a plain array. Runs in O(n): only the
+ * levels around the first violation and the two that set the direction are
+ * worth removing, so at most four skip-index checks are made.
+ *
+ * @param levels Array of levels.
+ * @param n Number of levels.
+ * @return 1 if some single removal makes the report safe, 0 otherwise.
+ */
+int levels_safe_dampened(const int *levels, size_t n);
+
+/// Safe report counts for both halves
+typedef struct {
+	int safe; // First half: safe as is
+	int safe_dampened; // Second half: safe with at most one level removed
+} reports_tally_t;
+
+/**
+ * Evaluates one report for both halves, one level at a time. Empty reports
+ * count for neither.
+ *
+ * @param t Tally to add the counts to.
+ * @param levels Array of levels.
+ * @param n Number of levels.
+ */
+void reports_tally_one(reports_tally_t *t, const int *levels, size_t n);
+
+/**
+ * Evaluates a range of already parsed reports for both halves, several at
+ * a time with the vector kernels of safety.h. Ranges are independent, so
+ * disjoint ones can be handed to different threads.
+ *
+ * @param reports One row of levels per report.
+ * @param first Index of the first report to evaluate.
+ * @param last One past the last report to evaluate.
+ * @param t Tally to add the counts to.
+ */
+void reports_tally_rows(const jagged_t *reports, size_t first, size_t last,
+			reports_tally_t *t);
+
+/**
+ * Same as reports_tally_rows() over all reports, split by row range across
+ * threads.
+ *
+ * @param reports One row of levels per report.
+ * @param threads Number of threads, 0 for one per online CPU.
+ * @param t Tally to add the counts to.
+ * @return 0 on success, -1 on failure.
+ */
+int reports_tally_parallel(const jagged_t *reports, int threads,
+			   reports_tally_t *t);
+
+/**
+ * Solves both halves for an in-memory input. Batches of lines are parsed
+ * into a flat jagged array that stays in cache, then its rows are
+ * evaluated; the array is reused for the next batch. Counts are added to t.
+ *
+ * @param begin First byte of the input.
+ * @param end One past the last byte of the input.
+ * @param t Tally to add the counts to.
+ */
+void reports_solve(const char *begin, const char *end, reports_tally_t *t);
+
+/**
+ * Same as reports_solve(), parsing into a caller-owned jagged array so its
+ * memory is reused across calls instead of allocated per input.
+ *
+ * @param reports Scratch array from jagged_init(), cleared before each batch.
+ * @param begin First byte of the input.
+ * @param end One past the last byte of the input.
+ * @param t Tally to add the counts to.
+ */
+void reports_solve_with(jagged_t *reports, const char *begin, const char *end,
+			reports_tally_t *t);
+
+/**
+ * Same as reports_solve(), with the input split across threads. Each thread
+ * takes a slice cut on line boundaries and keeps its own counters, which are
+ * summed at the end, so the result is identical to the serial pass.
+ *
+ * @param begin First byte of the input.
+ * @param end One past the last byte of the input.
+ * @param threads Number of threads, 0 for one per online CPU.
+ * @param t Tally to add the counts to.
+ * @return 0 on success, -1 on failure.
+ */
+int reports_solve_parallel(const char *begin, const char *end, int threads,
+			   reports_tally_t *t);
+
+/**
+ * Solves both halves by reading reports through the streaming reader, so
+ * memory stays bounded regardless of input size.
+ *
+ * @param f_name The name of the file to read, or NULL / "-" for stdin.
+ * @param t Tally to add the counts to.
+ * @return 0 on success, -1 on failure.
+ */
+int reports_solve_stream(const char *f_name, reports_tally_t *t);
+
+#endif // REPORTS_H
@@ -0,0 +1,95 @@
+#include "reports.h"
+#include "../helpers/bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/// One timed solve and its result
+typedef struct {
+	const char *input;
+	size_t len;
+	int threads; // 0 for the serial reports_solve()
+	jagged_t rows; // Parsed reports, for the two-pass kernels
+	reports_tally_t tally;
+} reports_job_t;
+
+static void run_solve(void *arg)
+{
+	reports_job_t *job = arg;
+	reports_tally_t t = { 0, 0 };
+
+	if (job->threads)
+		reports_solve_parallel(job->input, job->input + job->len,
+				       job->threads, &t);
+	else
+		reports_solve(job->input, job->input + job->len, &t);
+	job->tally = t;
+}
+
+static void run_parse(void *arg)
+{
+	reports_job_t *job = arg;
+
+	jagged_clear(&job->rows);
+	jagged_parse_ints(&job->rows, job->input, job->input + job->len);
+}
+
+static void run_rows(void *arg)
+{
+	reports_job_t *job = arg;
+	reports_tally_t t = { 0, 0 };
+
+	reports_tally_parallel(&job->rows, job->threads, &t);
+	job->tally = t;
+}
+
+static int check(const reports_job_t *job, const reports_tally_t *want,
+		 const char *name)
+{
+	if (job->tally.safe == want->safe &&
+	    job->tally.safe_dampened == want->safe_dampened)
+		return 0;
+
+	fprintf(stderr, "ERROR: %s gave %d/%d, serial %d/%d\n", name,
+		job->tally.safe, job->tally.safe_dampened, want->safe,
+		want->safe_dampened);
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	size_t reports = argc > 1 ? strtoul(argv[1], NULL, 10) :
+				    bench_scaled(10000000);
+	int max_threads = argc > 2 ? atoi(argv[2]) :
+				     (int)sysconf(_SC_NPROCESSORS_ONLN);
+	reports_job_t job = { 0 };
+	char *input = bench_gen_day2(reports, 42, &job.len);
+	char name[64];
+
+	job.input = input;
+	jagged_init(&job.rows);
+
+	bench_run("day2/serial", job.len, run_solve, &job);
+	reports_tally_t serial = job.tally;
+
+	for (job.threads = 1; job.threads <= max_threads; job.threads *= 2) {
+		snprintf(name, sizeof(name), "day2/threads=%d", job.threads);
+		bench_run(name, job.len, run_solve, &job);
+		if (check(&job, &serial, name))
+			return 1;
+	}
+
+	// The two passes of reports_solve() on their own, then rows by range
+	bench_run("day2/parse_jagged", job.len, run_parse, &job);
+
+	for (job.threads = 1; job.threads <= max_threads; job.threads *= 2) {
+		snprintf(name, sizeof(name), "day2/rows/threads=%d", job.threads);
+		bench_run(name, job.len, run_rows, &job);
+		if (check(&job, &serial, name))
+			return 1;
+	}
+
+	jagged_free(&job.rows);
+	free(input);
+	return 0;
+}
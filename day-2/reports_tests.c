@@ -0,0 +1,115 @@
+#include "reports.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+static vec_t *make_report(const int *levels, size_t n)
+{
+	vec_t *v = vec_create(TYPE_INT);
+	for (size_t i = 0; i < n; i++)
+		vec_push_back(v, &levels[i]);
+	return v;
+}
+
+void test_sample_reports(void)
+{
+	// The six reports from data.test: safe, unsafe x4, safe
+	static const int reports[6][5] = {
+		{ 7, 6, 4, 2, 1 }, { 1, 2, 7, 8, 9 }, { 9, 7, 6, 2, 1 },
+		{ 1, 3, 2, 4, 5 }, { 8, 6, 4, 4, 1 }, { 1, 3, 6, 7, 9 },
+	};
+	static const int safe[6] = { 1, 0, 0, 0, 0, 1 };
+	static const int dampened[6] = { 1, 0, 0, 1, 1, 1 };
+
+	for (size_t r = 0; r < 6; r++) {
+		vec_t *v = make_report(reports[r], 5);
+		assert(issafe(v) == safe[r]);
+		assert(levels_safe(reports[r], 5, 5) == safe[r]);
+		assert((issafe(v) || issafe_with_dampener(v)) == dampened[r]);
+		vec_destroy(v);
+	}
+	printf("test_sample_reports passed.\n");
+}
+
+void test_short_reports(void)
+{
+	int levels[] = { 5, 6 };
+
+	for (size_t n = 0; n <= 2; n++) {
+		vec_t *v = make_report(levels, n);
+		assert(issafe_with_dampener(v) == issafe_with_dampener_naive(v));
+		vec_destroy(v);
+	}
+	printf("test_short_reports passed.\n");
+}
+
+void test_dampener_differential(void)
+{
+	int levels[12];
+	unsigned seed = 12345;
+
+	srand(seed);
+	for (int iter = 0; iter < 200000; iter++) {
+		size_t n = rand() % 12;
+
+		// Mostly small steps so that safe and almost-safe reports are common
+		levels[0] = rand() % 20;
+		for (size_t i = 1; i < n; i++)
+			levels[i] = levels[i - 1] + (rand() % 9) - 4;
+
+		vec_t *v = make_report(levels, n);
+		int want = issafe_with_dampener_naive(v);
+		int got = issafe_with_dampener(v);
+		if (want != got) {
+			fprintf(stderr, "Mismatch (naive %d, fast %d): ", want, got);
+			vec_print(v);
+		}
+		assert(want == got);
+		assert(issafe(v) == levels_safe(levels, n, n));
+		vec_destroy(v);
+	}
+	printf("test_dampener_differential passed.\n");
+}
+
+void test_row_ranges(void)
+{
+	static const char input[] = "7 6 4 2 1\n1 2 7 8 9\n\n9 7 6 2 1\n"
+				    "1 3 2 4 5\n8 6 4 4 1\n1 3 6 7 9";
+	const char *end = input + sizeof(input) - 1;
+	reports_tally_t whole = { 0, 0 };
+	jagged_t reports;
+
+	reports_solve(input, end, &whole);
+	assert(whole.safe == 2 && whole.safe_dampened == 4);
+
+	jagged_init(&reports);
+	assert(jagged_parse_ints(&reports, input, end) == 6);
+
+	// Any split into ranges adds up to the whole
+	for (size_t cut = 0; cut <= 6; cut++) {
+		reports_tally_t t = { 0, 0 };
+		reports_tally_rows(&reports, 0, cut, &t);
+		reports_tally_rows(&reports, cut, 6, &t);
+		assert(t.safe == whole.safe && t.safe_dampened == whole.safe_dampened);
+	}
+
+	for (int threads = 0; threads <= 8; threads++) {
+		reports_tally_t t = { 0, 0 };
+		assert(reports_tally_parallel(&reports, threads, &t) == 0);
+		assert(t.safe == whole.safe && t.safe_dampened == whole.safe_dampened);
+	}
+
+	jagged_free(&reports);
+	printf("test_row_ranges passed.\n");
+}
+
+int main(void)
+{
+	test_sample_reports();
+	test_short_reports();
+	test_dampener_differential();
+	test_row_ranges();
+
+	printf("All tests passed.\n");
+	return 0;
+}
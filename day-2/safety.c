@@ -0,0 +1,252 @@
+#include "safety.h"
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SAFETY_X86 1
+#endif
+
+/// Widest vector, in reports
+#define SAFETY_MAX_LANES 8
+
+/// Evaluates `lanes` reports of n levels each, padded to the kernel width
+typedef void (*safety_group_fn)(const int *const *rows, size_t n, int lanes,
+				reports_tally_t *t);
+
+#ifdef SAFETY_X86
+/*
+ * Both kernels work on the steps d[i] = level[i + 1] - level[i] of `width`
+ * reports at once. up[i] / down[i] are all-ones lanes where step i is a
+ * valid rise / fall. Dropping level j keeps steps 0..j-2 and j+1..n-2 and
+ * bridges j-1 to j+1, so prefix and suffix ANDs of up/down answer every j
+ * with one more compare.
+ */
+
+__attribute__((target("sse2"))) static void
+safety_group_sse2(const int *const *rows, size_t n, int lanes,
+		  reports_tally_t *t)
+{
+	int32_t lvl[SAFETY_MAX_LEVELS][4] __attribute__((aligned(16)));
+	__m128i v[SAFETY_MAX_LEVELS];
+	__m128i pre_up[SAFETY_MAX_LEVELS], pre_down[SAFETY_MAX_LEVELS];
+	__m128i suf_up[SAFETY_MAX_LEVELS], suf_down[SAFETY_MAX_LEVELS];
+	const __m128i zero = _mm_setzero_si128(), ones = _mm_set1_epi32(-1);
+	const __m128i four = _mm_set1_epi32(4), minus_four = _mm_set1_epi32(-4);
+
+	// Transpose: one vector per level index
+	for (size_t i = 0; i < n; i++) {
+		for (int k = 0; k < 4; k++)
+			lvl[i][k] = rows[k][i];
+		v[i] = _mm_load_si128((const __m128i *)lvl[i]);
+	}
+
+#define SAFETY_UP_SSE2(d) \
+	_mm_and_si128(_mm_cmpgt_epi32(d, zero), _mm_cmpgt_epi32(four, d))
+#define SAFETY_DOWN_SSE2(d) \
+	_mm_and_si128(_mm_cmpgt_epi32(zero, d), _mm_cmpgt_epi32(d, minus_four))
+
+	// pre_*[i]: steps 0..i-1 valid, suf_*[i]: steps i..n-2 valid
+	pre_up[0] = pre_down[0] = ones;
+	for (size_t i = 0; i + 1 < n; i++) {
+		__m128i d = _mm_sub_epi32(v[i + 1], v[i]);
+		pre_up[i + 1] = _mm_and_si128(pre_up[i], SAFETY_UP_SSE2(d));
+		pre_down[i + 1] = _mm_and_si128(pre_down[i], SAFETY_DOWN_SSE2(d));
+	}
+	suf_up[n - 1] = suf_down[n - 1] = ones;
+	for (size_t i = n - 1; i-- > 0;) {
+		__m128i d = _mm_sub_epi32(v[i + 1], v[i]);
+		suf_up[i] = _mm_and_si128(suf_up[i + 1], SAFETY_UP_SSE2(d));
+		suf_down[i] = _mm_and_si128(suf_down[i + 1], SAFETY_DOWN_SSE2(d));
+	}
+
+	__m128i safe = _mm_or_si128(pre_up[n - 1], pre_down[n - 1]);
+	__m128i damp = _mm_or_si128(safe, _mm_or_si128(suf_up[1], suf_down[1]));
+	damp = _mm_or_si128(damp, _mm_or_si128(pre_up[n - 2], pre_down[n - 2]));
+
+	for (size_t j = 1; j + 1 < n; j++) {
+		__m128i b = _mm_sub_epi32(v[j + 1], v[j - 1]);
+		__m128i up = _mm_and_si128(_mm_and_si128(pre_up[j - 1],
+							 suf_up[j + 1]),
+					   SAFETY_UP_SSE2(b));
+		__m128i down = _mm_and_si128(_mm_and_si128(pre_down[j - 1],
+							   suf_down[j + 1]),
+					     SAFETY_DOWN_SSE2(b));
+		damp = _mm_or_si128(damp, _mm_or_si128(up, down));
+	}
+
+#undef SAFETY_UP_SSE2
+#undef SAFETY_DOWN_SSE2
+
+	int mask = (1 << lanes) - 1;
+	t->safe += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(safe)) &
+				      mask);
+	t->safe_dampened += __builtin_popcount(
+		_mm_movemask_ps(_mm_castsi128_ps(damp)) & mask);
+}
+
+__attribute__((target("avx2"))) static void
+safety_group_avx2(const int *const *rows, size_t n, int lanes,
+		  reports_tally_t *t)
+{
+	int32_t lvl[SAFETY_MAX_LEVELS][8] __attribute__((aligned(32)));
+	__m256i v[SAFETY_MAX_LEVELS];
+	__m256i pre_up[SAFETY_MAX_LEVELS], pre_down[SAFETY_MAX_LEVELS];
+	__m256i suf_up[SAFETY_MAX_LEVELS], suf_down[SAFETY_MAX_LEVELS];
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i ones = _mm256_set1_epi32(-1);
+	const __m256i four = _mm256_set1_epi32(4);
+	const __m256i minus_four = _mm256_set1_epi32(-4);
+
+	for (size_t i = 0; i < n; i++) {
+		for (int k = 0; k < 8; k++)
+			lvl[i][k] = rows[k][i];
+		v[i] = _mm256_load_si256((const __m256i *)lvl[i]);
+	}
+
+#define SAFETY_UP_AVX2(d) \
+	_mm256_and_si256(_mm256_cmpgt_epi32(d, zero), _mm256_cmpgt_epi32(four, d))
+#define SAFETY_DOWN_AVX2(d)                          \
+	_mm256_and_si256(_mm256_cmpgt_epi32(zero, d), \
+			 _mm256_cmpgt_epi32(d, minus_four))
+
+	pre_up[0] = pre_down[0] = ones;
+	for (size_t i = 0; i + 1 < n; i++) {
+		__m256i d = _mm256_sub_epi32(v[i + 1], v[i]);
+		pre_up[i + 1] = _mm256_and_si256(pre_up[i], SAFETY_UP_AVX2(d));
+		pre_down[i + 1] =
+			_mm256_and_si256(pre_down[i], SAFETY_DOWN_AVX2(d));
+	}
+	suf_up[n - 1] = suf_down[n - 1] = ones;
+	for (size_t i = n - 1; i-- > 0;) {
+		__m256i d = _mm256_sub_epi32(v[i + 1], v[i]);
+		suf_up[i] = _mm256_and_si256(suf_up[i + 1], SAFETY_UP_AVX2(d));
+		suf_down[i] =
+			_mm256_and_si256(suf_down[i + 1], SAFETY_DOWN_AVX2(d));
+	}
+
+	__m256i safe = _mm256_or_si256(pre_up[n - 1], pre_down[n - 1]);
+	__m256i damp = _mm256_or_si256(safe,
+				       _mm256_or_si256(suf_up[1], suf_down[1]));
+	damp = _mm256_or_si256(damp, _mm256_or_si256(pre_up[n - 2],
+						     pre_down[n - 2]));
+
+	for (size_t j = 1; j + 1 < n; j++) {
+		__m256i b = _mm256_sub_epi32(v[j + 1], v[j - 1]);
+		__m256i up = _mm256_and_si256(
+			_mm256_and_si256(pre_up[j - 1], suf_up[j + 1]),
+			SAFETY_UP_AVX2(b));
+		__m256i down = _mm256_and_si256(
+			_mm256_and_si256(pre_down[j - 1], suf_down[j + 1]),
+			SAFETY_DOWN_AVX2(b));
+		damp = _mm256_or_si256(damp, _mm256_or_si256(up, down));
+	}
+
+#undef SAFETY_UP_AVX2
+#undef SAFETY_DOWN_AVX2
+
+	int mask = (1 << lanes) - 1;
+	t->safe += __builtin_popcount(
+		_mm256_movemask_ps(_mm256_castsi256_ps(safe)) & mask);
+	t->safe_dampened += __builtin_popcount(
+		_mm256_movemask_ps(_mm256_castsi256_ps(damp)) & mask);
+}
+#endif
+
+/// A kernel and its width in reports, swapped in as a whole
+typedef struct {
+	safety_group_fn group; // NULL: every report goes through reports_tally_one()
+	int width;
+} safety_kernel_t;
+
+static const safety_kernel_t safety_scalar = { NULL, 1 };
+#ifdef SAFETY_X86
+static const safety_kernel_t safety_sse2 = { safety_group_sse2, 4 };
+static const safety_kernel_t safety_avx2 = { safety_group_avx2, 8 };
+#endif
+
+/// NULL until the first safety_use(); read by every worker thread, so it is
+/// only ever stored and loaded atomically
+static const safety_kernel_t *safety_kernel;
+
+int safety_use(safety_impl_t impl)
+{
+	const safety_kernel_t *kernel;
+
+	switch (impl) {
+	case SAFETY_AUTO:
+#ifdef SAFETY_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return safety_use(SAFETY_AVX2);
+		if (__builtin_cpu_supports("sse2"))
+			return safety_use(SAFETY_SSE2);
+#endif
+		return safety_use(SAFETY_SCALAR);
+	case SAFETY_SCALAR:
+		kernel = &safety_scalar;
+		break;
+#ifdef SAFETY_X86
+	case SAFETY_SSE2:
+		__builtin_cpu_init();
+		if (!__builtin_cpu_supports("sse2"))
+			return -1;
+		kernel = &safety_sse2;
+		break;
+	case SAFETY_AVX2:
+		__builtin_cpu_init();
+		if (!__builtin_cpu_supports("avx2"))
+			return -1;
+		kernel = &safety_avx2;
+		break;
+#endif
+	default:
+		return -1;
+	}
+
+	__atomic_store_n(&safety_kernel, kernel, __ATOMIC_RELEASE);
+	return 0;
+}
+
+void safety_tally_rows(const jagged_t *reports, size_t first, size_t last,
+		       reports_tally_t *t)
+{
+	// Rows waiting for a full vector, one bucket per length
+	const int *bucket[SAFETY_MAX_LEVELS + 1][SAFETY_MAX_LANES];
+	int filled[SAFETY_MAX_LEVELS + 1] = { 0 };
+
+	// Threads racing through the first use all store the same kernel
+	const safety_kernel_t *kernel =
+		__atomic_load_n(&safety_kernel, __ATOMIC_ACQUIRE);
+	if (!kernel) {
+		safety_use(SAFETY_AUTO);
+		kernel = __atomic_load_n(&safety_kernel, __ATOMIC_ACQUIRE);
+	}
+
+	safety_group_fn group = kernel->group;
+	int width = kernel->width;
+
+	for (size_t r = first; r < last; r++) {
+		jagged_row_t row = jagged_row(reports, r);
+
+		// Under 3 levels the dampener never applies
+		if (!group || row.len < 3 || row.len > SAFETY_MAX_LEVELS) {
+			reports_tally_one(t, row.values, row.len);
+			continue;
+		}
+
+		bucket[row.len][filled[row.len]++] = row.values;
+		if (filled[row.len] == width) {
+			group(bucket[row.len], row.len, width, t);
+			filled[row.len] = 0;
+		}
+	}
+
+	// Pad the leftovers with their first row and count only the real lanes
+	for (size_t n = 3; group && n <= SAFETY_MAX_LEVELS; n++) {
+		if (!filled[n])
+			continue;
+		for (int k = filled[n]; k < width; k++)
+			bucket[n][k] = bucket[n][0];
+		group(bucket[n], n, filled[n], t);
+	}
+}
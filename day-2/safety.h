@@ -0,0 +1,44 @@
+#ifndef SAFETY_H
+#define SAFETY_H
+
+#include <stddef.h> // For size_t
+#include "../helpers/jagged.h"
+#include "reports.h"
+
+/// Longest report the vector kernels take, longer ones are checked one by one
+#define SAFETY_MAX_LEVELS 16
+
+/// How safety_tally_rows() evaluates reports
+typedef enum {
+	SAFETY_AUTO, // Best one supported by the running CPU
+	SAFETY_SCALAR, // One report at a time, levels_safe_dampened()
+	SAFETY_SSE2, // 4 reports of the same length per vector
+	SAFETY_AVX2 // 8 reports of the same length per vector
+} safety_impl_t;
+
+/**
+ * Forces the kernel used by safety_tally_rows(). By default the best
+ * supported one is picked on first use; this is mostly for benchmarks and
+ * tests.
+ *
+ * @param impl The implementation to use.
+ * @return 0 on success, -1 if the running CPU does not support it.
+ */
+int safety_use(safety_impl_t impl);
+
+/**
+ * Same as reports_tally_rows(), evaluating many reports at once. Rows are
+ * bucketed by length; a full bucket is transposed so that level i of every
+ * report sits in one vector, and the step rules, with and without the
+ * dampener, are checked for all of them with a few compares per level. No
+ * branch depends on the levels.
+ *
+ * @param reports Parsed reports.
+ * @param first First row to evaluate.
+ * @param last One past the last row to evaluate.
+ * @param t Tally to add the counts to.
+ */
+void safety_tally_rows(const jagged_t *reports, size_t first, size_t last,
+		       reports_tally_t *t);
+
+#endif // SAFETY_H
@@ -0,0 +1,76 @@
+#include "safety.h"
+#include "../helpers/bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/// Parsed reports, evaluated `rounds` times per timed run
+typedef struct {
+	jagged_t rows;
+	size_t rounds;
+	reports_tally_t tally;
+} safety_job_t;
+
+static void run_tally(void *arg)
+{
+	safety_job_t *job = arg;
+	reports_tally_t t = { 0, 0 };
+
+	for (size_t i = 0; i < job->rounds; i++)
+		safety_tally_rows(&job->rows, 0, jagged_rows(&job->rows), &t);
+	job->tally = t;
+}
+
+int main(int argc, char **argv)
+{
+	static const struct {
+		safety_impl_t impl;
+		const char *name;
+	} impls[] = {
+		{ SAFETY_SCALAR, "day2_eval/scalar" },
+		{ SAFETY_SSE2, "day2_eval/sse2" },
+		{ SAFETY_AVX2, "day2_eval/avx2" },
+	};
+	size_t total = argc > 1 ? strtoul(argv[1], NULL, 10) :
+				  bench_scaled(100000000);
+	size_t block = total < 1000000 ? total : 1000000;
+	safety_job_t job = { 0 };
+	size_t len;
+
+	// A block that fits in memory comfortably, evaluated until `total`
+	// reports have gone through the kernel
+	char *input = bench_gen_day2(block, 42, &len);
+	jagged_init(&job.rows);
+	jagged_parse_ints(&job.rows, input, input + len);
+	free(input);
+	job.rounds = (total + block - 1) / block;
+
+	size_t bytes = ivec_size(&job.rows.values) * sizeof(int) * job.rounds;
+	bench_note("day2_eval: %zu reports (%zu x %zu)", block * job.rounds,
+		   job.rounds, block);
+
+	reports_tally_t want = { 0, 0 };
+	for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+		if (safety_use(impls[i].impl) < 0) {
+			bench_note("%s: not supported, skipped", impls[i].name);
+			continue;
+		}
+
+		double seconds = bench_run(impls[i].name, bytes, run_tally, &job);
+		bench_note("%s: %.1f M reports/s", impls[i].name,
+			   block * job.rounds / seconds * 1e-6);
+
+		if (i == 0) {
+			want = job.tally;
+		} else if (job.tally.safe != want.safe ||
+			   job.tally.safe_dampened != want.safe_dampened) {
+			fprintf(stderr, "ERROR: %s gave %d/%d, scalar %d/%d\n",
+				impls[i].name, job.tally.safe,
+				job.tally.safe_dampened, want.safe,
+				want.safe_dampened);
+			return 1;
+		}
+	}
+
+	jagged_free(&job.rows);
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include "safety.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/// Reports of 1 to 20 levels whose steps are mostly valid, so every
+/// outcome shows up: safe, safe once dampened, unsafe
+static void make_reports(jagged_t *j, size_t count, unsigned seed)
+{
+	static const int steps[] = { 1, 2, 3, 1, 2, 3, 0, 4, 7, -1, -2, -3 };
+
+	srand(seed);
+	for (size_t r = 0; r < count; r++) {
+		size_t n = 1 + rand() % 20;
+		int dir = rand() % 2 ? 1 : -1;
+		int level = rand() % 200 - 100;
+
+		for (size_t i = 0; i < n; i++) {
+			jagged_push(j, level);
+			level += dir * steps[rand() % 12];
+		}
+		jagged_end_row(j);
+	}
+}
+
+/// What issafe() and the brute-force dampener say, one report at a time:
+/// nothing here shares code with the kernels or levels_safe_dampened()
+static reports_tally_t reference_tally(const jagged_t *j)
+{
+	reports_tally_t t = { 0, 0 };
+	vec_t *v = vec_create(TYPE_INT);
+
+	for (size_t r = 0; r < jagged_rows(j); r++) {
+		jagged_row_t row = jagged_row(j, r);
+
+		vec_clear(v);
+		vec_push_n(v, row.values, row.len);
+		if (issafe(v)) {
+			t.safe++;
+			t.safe_dampened++;
+		} else if (issafe_with_dampener_naive(v)) {
+			t.safe_dampened++;
+		}
+	}
+
+	vec_destroy(v);
+	return t;
+}
+
+void test_impls_match_reference(void)
+{
+	static const safety_impl_t impls[] = { SAFETY_SCALAR, SAFETY_SSE2,
+					       SAFETY_AVX2 };
+	jagged_t j;
+
+	jagged_init(&j);
+	make_reports(&j, 20000, 7);
+	reports_tally_t want = reference_tally(&j);
+	assert(want.safe > 0 && want.safe_dampened > want.safe);
+
+	for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+		if (safety_use(impls[i]) < 0) {
+			printf("impl %d not supported, skipped\n", (int)impls[i]);
+			continue;
+		}
+
+		reports_tally_t got = { 0, 0 };
+		safety_tally_rows(&j, 0, jagged_rows(&j), &got);
+		assert(got.safe == want.safe);
+		assert(got.safe_dampened == want.safe_dampened);
+	}
+
+	safety_use(SAFETY_AUTO);
+	jagged_free(&j);
+	printf("test_impls_match_reference passed.\n");
+}
+
+void test_partial_groups(void)
+{
+	// Fewer rows of each length than a vector holds: all in padded groups
+	static const int rows[][5] = {
+		{ 7, 6, 4, 2, 1 }, { 1, 2, 7, 8, 9 }, { 9, 7, 6, 2, 1 },
+		{ 1, 3, 2, 4, 5 }, { 8, 6, 4, 4, 1 }, { 1, 3, 6, 7, 9 },
+	};
+	jagged_t j;
+
+	jagged_init(&j);
+	for (size_t r = 0; r < 6; r++) {
+		for (size_t i = 0; i < 5; i++)
+			jagged_push(&j, rows[r][i]);
+		jagged_end_row(&j);
+	}
+
+	for (safety_impl_t impl = SAFETY_SCALAR; impl <= SAFETY_AVX2; impl++) {
+		if (safety_use(impl) < 0)
+			continue;
+
+		// Every prefix, so each group size from 1 up is exercised
+		for (size_t last = 1; last <= 6; last++) {
+			reports_tally_t t = { 0, 0 };
+			static const int safe[] = { 1, 1, 1, 1, 1, 2 };
+			static const int damp[] = { 1, 1, 1, 2, 3, 4 };
+
+			safety_tally_rows(&j, 0, last, &t);
+			assert(t.safe == safe[last - 1]);
+			assert(t.safe_dampened == damp[last - 1]);
+		}
+	}
+
+	safety_use(SAFETY_AUTO);
+	jagged_free(&j);
+	printf("test_partial_groups passed.\n");
+}
+
+int main(void)
+{
+	test_impls_match_reference();
+	test_partial_groups();
+	printf("All tests passed.\n");
+	return 0;
+}
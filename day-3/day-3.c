@@ -1,131 +1,97 @@
-#include <assert.h>
-#include <ctype.h>
 #include <stdio.h>
-#include "../helpers/helpers.h"
 #include <stdlib.h>
 #include <string.h>
+#include "../helpers/helpers.h"
+#include "../helpers/rcache.h"
+#include "../helpers/stats.h"
+#include "scanner.h"
 
-typedef enum part { PART_ONE, PART_TWO } part_t;
-
-int parse_tok(const char *token)
-{
-	if (strlen(token) < 3)
-		return 0;
-
-	if (!isdigit(token[0]))
-		return 0;
-
-	const char *tmp_token = strndup(token, strlen(token));
-
-	int i = 0;
-	while (isdigit(token[i]))
-		i++;
-
-	char *first_number = malloc(sizeof(char *) * i);
-	strncpy(first_number, tmp_token, i);
-
-	if (token[i] != ',')
-		return 0;
-
-	int j = i + 1;
-	if (!isdigit(token[j]))
-		return 0;
-
-	while (isdigit(token[j]))
-		j++;
-
-	if (token[j] != ')')
-		return 0;
-
-	j--;
-	j--;
-
-	int k = i + 1;
-	while (k--)
-		tmp_token++;
-
-	char *second_number = malloc(sizeof(char *) * j - (i - 1));
-	strncpy(second_number, tmp_token, j - (i - 1));
-
-	/* printf("%s * %s\n", first_number, second_number); */
-	return (strtoul(first_number, NULL, 10) *
-		strtoul(second_number, NULL, 10));
-}
-
-int part(char *f_content, part_t p)
+int main(int argc, char **argv)
 {
-	int result = 0;
-	char *rem;
-	char *token;
-	char *delim = "mul(";
-	int enabled = 1;
-
-	token = strsplit_r(f_content, delim, &rem);
-	if (strstr(token, "don\'t()") != NULL)
-		enabled = 0;
-
-	while (token != NULL) {
-		if (strlen(token) < 4)
-			goto skip;
+	const char *f_name = "data.input";
+	int threads = 1;
+	int use_stream = 0;
+	rcache_opts_t cache_opts = { 0 };
+	int use_cache;
+	stats_mode_t stats = STATS_OFF;
+	scanner_t s;
+	mfile_t mf;
+	rcache_t cache;
+	rcache_key_t key;
+	long long answers[2];
+
+	for (int arg = 1; arg < argc; arg++) {
+		if (strcmp(argv[arg], "--stream") == 0)
+			use_stream = 1;
+		else if (strncmp(argv[arg], "--threads=", 10) == 0)
+			threads = atoi(argv[arg] + 10); // 0: one per CPU
+		else if (stats_parse_arg(argv[arg], &stats))
+			continue;
+		else if (rcache_parse_arg(argv[arg], &cache_opts))
+			continue;
+		else
+			f_name = argv[arg];
+	}
 
-		int ret = 0;
+	use_cache = rcache_open_solver(&cache, &cache_opts, RCACHE_DAY3,
+				       use_stream);
+	if (use_cache < 0)
+		return 1;
+
+	int ret;
+	if (use_stream) {
+		scanner_init(&s);
+		{
+			STATS_SCOPE("scan_stream");
+			ret = scanner_scan_stream(&s, f_name);
+		}
+		if (ret < 0)
+			return 1;
 
-		switch (p) {
-		case PART_ONE:
-			ret = parse_tok(token);
-			if (!ret)
-				goto skip;
-			result += ret;
-			break;
-		case PART_TWO:
-			ret = parse_tok(token);
-			if (!ret)
-				goto skip;
+		answers[0] = s.part_one;
+		answers[1] = s.part_two;
+		goto print;
+	}
 
-			if (enabled) {
-				printf("ENABLED TOK: %s\tret: %d\n", token,
-				       ret);
-				result += ret;
-			} else {
-				printf("DISABLED TOK: %s\n", token);
-			}
+	{
+		STATS_SCOPE("load");
+		ret = mfile_open(f_name, &mf);
+	}
+	if (ret < 0) {
+		perror("ERROR: Failed to read file");
+		return 1;
+	}
 
-			if (strstr(token, "do()") != NULL) {
-				printf("ENABLED from token: %s\n", token);
-				enabled = 1;
-			}
-			if (strstr(token, "don\'t()") != NULL) {
-				printf("DISABLED from token: %s\n", token);
-				enabled = 0;
-			}
+	if (use_cache) {
+		key = rcache_key(RCACHE_DAY3, mf.begin, mf.end);
+		if (rcache_get(&cache, &key, answers, 2)) {
+			mfile_close(&mf);
+			goto print;
 		}
-skip:
-		token = strsplit_r(rem, delim, &rem);
 	}
 
-	return result;
-}
-
-int main(void)
-{
-	// const char *f_name = "data.input";
-	// int ret = 0;
-	// char *f_content = NULL;
+	scanner_init(&s);
+	{
+		STATS_SCOPE("scan");
+		ret = scanner_scan_parallel(&s, mf.begin, mf.end, threads);
+	}
+	mfile_close(&mf);
+	if (ret < 0)
+		return 1;
 
-	// ret = read_file(f_name, &f_content);
-	// if (ret < 0) {
-	// 	perror("ERROR: Failed to read file");
-	// 	return 1;
-	// }
+	answers[0] = s.part_one;
+	answers[1] = s.part_two;
+	if (use_cache)
+		rcache_put(&cache, &key, answers, 2);
 
-	const char *f_content = "don't()mul(3,3)mul(4,4)";
-	int result = 0;
+print:
+	printf("Result: %lld\n", answers[0]);
+	printf("Result: %lld\n", answers[1]);
 
-	/* part(strdup(f_content), PART_ONE); */
-	result = part(strdup(f_content), PART_TWO);
-	assert(result == 0);
-	/* printf("Result: %d\n", result); */
+	if (use_cache)
+		rcache_close(&cache);
 
-	// free(f_content);
+	if (stats)
+		stats_print(stats == STATS_JSON);
 	return 0;
 }
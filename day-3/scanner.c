@@ -0,0 +1,455 @@
+#include "scanner.h"
+#include "../helpers/stats.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCANNER_X86 1
+#endif
+
+void scanner_init(scanner_t *s)
+{
+	s->state = SCAN_IDLE;
+	s->a = 0;
+	s->b = 0;
+	s->digits = 0;
+	s->enabled = 1;
+	s->part_one = 0;
+	s->part_two = 0;
+	s->pending = 0;
+}
+
+void scanner_init_chunk(scanner_t *s)
+{
+	scanner_init(s);
+	s->enabled = -1;
+}
+
+static inline int scan_digit(char c)
+{
+	return (unsigned char)(c - '0') < 10;
+}
+
+/// Advance the DFA by one byte. Returns 0 if the byte does not continue the
+/// current instruction, leaving the state untouched.
+static inline int scanner_advance(scanner_t *s, char c)
+{
+	switch (s->state) {
+	case SCAN_IDLE:
+		break;
+	case SCAN_M:
+		if (c == 'u') {
+			s->state = SCAN_MU;
+			return 1;
+		}
+		break;
+	case SCAN_MU:
+		if (c == 'l') {
+			s->state = SCAN_MUL;
+			return 1;
+		}
+		break;
+	case SCAN_MUL:
+		if (c == '(') {
+			s->state = SCAN_A;
+			s->a = 0;
+			s->digits = 0;
+			return 1;
+		}
+		break;
+	case SCAN_A:
+		if (scan_digit(c) && s->digits < 3) {
+			s->a = s->a * 10 + (c - '0');
+			s->digits++;
+			return 1;
+		}
+		if (c == ',' && s->digits) {
+			s->state = SCAN_B;
+			s->b = 0;
+			s->digits = 0;
+			return 1;
+		}
+		break;
+	case SCAN_B:
+		if (scan_digit(c) && s->digits < 3) {
+			s->b = s->b * 10 + (c - '0');
+			s->digits++;
+			return 1;
+		}
+		if (c == ')' && s->digits) {
+			long long product = (long long)s->a * s->b;
+			s->part_one += product;
+			if (s->enabled > 0)
+				s->part_two += product;
+			else if (s->enabled < 0) // Depends on the previous chunk
+				s->pending += product;
+			s->state = SCAN_IDLE;
+			return 1;
+		}
+		break;
+	case SCAN_D:
+		if (c == 'o') {
+			s->state = SCAN_DO;
+			return 1;
+		}
+		break;
+	case SCAN_DO:
+		if (c == '(') {
+			s->state = SCAN_DO_OPEN;
+			return 1;
+		}
+		if (c == 'n') {
+			s->state = SCAN_DON;
+			return 1;
+		}
+		break;
+	case SCAN_DO_OPEN:
+		if (c == ')') {
+			s->enabled = 1;
+			s->state = SCAN_IDLE;
+			return 1;
+		}
+		break;
+	case SCAN_DON:
+		if (c == '\'') {
+			s->state = SCAN_DON_QUOTE;
+			return 1;
+		}
+		break;
+	case SCAN_DON_QUOTE:
+		if (c == 't') {
+			s->state = SCAN_DONT;
+			return 1;
+		}
+		break;
+	case SCAN_DONT:
+		if (c == '(') {
+			s->state = SCAN_DONT_OPEN;
+			return 1;
+		}
+		break;
+	case SCAN_DONT_OPEN:
+		if (c == ')') {
+			s->enabled = 0;
+			s->state = SCAN_IDLE;
+			return 1;
+		}
+		break;
+	}
+
+	return 0;
+}
+
+/// Advance the DFA by one byte, starting a new instruction if needed
+static inline void scanner_step(scanner_t *s, char c)
+{
+	if (scanner_advance(s, c))
+		return;
+
+	// No transition: the byte may start the next instruction. 'm' and 'd'
+	// never appear after the first byte of an instruction, so restarting
+	// here can't skip over a match.
+	s->state = c == 'm' ? SCAN_M : c == 'd' ? SCAN_D : SCAN_IDLE;
+}
+
+/// Find the next "mu" or "do" (or a lone 'm'/'d' as the very last byte,
+/// which may continue in the next buffer), or end
+typedef const char *(*scan_find_fn)(const char *, const char *);
+
+static inline int scan_candidate(const char *p, const char *end)
+{
+	if (*p == 'm')
+		return p + 1 == end || p[1] == 'u';
+	if (*p == 'd')
+		return p + 1 == end || p[1] == 'o';
+	return 0;
+}
+
+static const char *scan_find_tail(const char *p, const char *end)
+{
+	for (; p < end; p++)
+		if (scan_candidate(p, end))
+			return p;
+	return end;
+}
+
+#ifdef SCANNER_X86
+__attribute__((target("sse2"))) static const char *
+scan_find_sse2(const char *p, const char *end)
+{
+	const __m128i m_c = _mm_set1_epi8('m'), u_c = _mm_set1_epi8('u');
+	const __m128i d_c = _mm_set1_epi8('d'), o_c = _mm_set1_epi8('o');
+
+	// Compare each byte and the one after it, 16 positions at a time
+	for (; end - p > 16; p += 16) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)p);
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(p + 1));
+		__m128i mu = _mm_and_si128(_mm_cmpeq_epi8(v0, m_c),
+					   _mm_cmpeq_epi8(v1, u_c));
+		__m128i d_o = _mm_and_si128(_mm_cmpeq_epi8(v0, d_c),
+					    _mm_cmpeq_epi8(v1, o_c));
+		uint32_t hits = _mm_movemask_epi8(_mm_or_si128(mu, d_o));
+		if (hits)
+			return p + __builtin_ctz(hits);
+	}
+
+	return scan_find_tail(p, end);
+}
+
+__attribute__((target("avx2"))) static const char *
+scan_find_avx2(const char *p, const char *end)
+{
+	const __m256i m_c = _mm256_set1_epi8('m'), u_c = _mm256_set1_epi8('u');
+	const __m256i d_c = _mm256_set1_epi8('d'), o_c = _mm256_set1_epi8('o');
+
+	for (; end - p > 32; p += 32) {
+		__m256i v0 = _mm256_loadu_si256((const __m256i *)p);
+		__m256i v1 = _mm256_loadu_si256((const __m256i *)(p + 1));
+		__m256i mu = _mm256_and_si256(_mm256_cmpeq_epi8(v0, m_c),
+					      _mm256_cmpeq_epi8(v1, u_c));
+		__m256i d_o = _mm256_and_si256(_mm256_cmpeq_epi8(v0, d_c),
+					       _mm256_cmpeq_epi8(v1, o_c));
+		uint32_t hits = _mm256_movemask_epi8(_mm256_or_si256(mu, d_o));
+		if (hits)
+			return p + __builtin_ctz(hits);
+	}
+
+	return scan_find_tail(p, end);
+}
+#endif
+
+/// Chosen as the prefilter for no prefilter: every byte goes through the DFA
+static const char *scan_find_none(const char *p, const char *end)
+{
+	(void)end;
+	return p;
+}
+
+/// NULL until the first scanner_use(); read by every worker of
+/// scanner_scan_parallel(), so it is only ever stored and loaded atomically
+static scan_find_fn scan_find;
+
+int scanner_use(scanner_impl_t impl)
+{
+	scan_find_fn find;
+
+	switch (impl) {
+	case SCANNER_AUTO:
+#ifdef SCANNER_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return scanner_use(SCANNER_AVX2);
+		if (__builtin_cpu_supports("sse2"))
+			return scanner_use(SCANNER_SSE2);
+#endif
+		return scanner_use(SCANNER_SCALAR);
+	case SCANNER_SCALAR:
+		find = scan_find_none;
+		break;
+#ifdef SCANNER_X86
+	case SCANNER_SSE2:
+		__builtin_cpu_init();
+		if (!__builtin_cpu_supports("sse2"))
+			return -1;
+		find = scan_find_sse2;
+		break;
+	case SCANNER_AVX2:
+		__builtin_cpu_init();
+		if (!__builtin_cpu_supports("avx2"))
+			return -1;
+		find = scan_find_avx2;
+		break;
+#endif
+	default:
+		return -1;
+	}
+
+	__atomic_store_n(&scan_find, find, __ATOMIC_RELEASE);
+	return 0;
+}
+
+void scanner_scan(scanner_t *s, const char *begin, const char *end)
+{
+	const char *p = begin;
+
+	STATS_COUNT("bytes_scanned", end - begin);
+
+	// Threads racing through the first use all store the same prefilter
+	scan_find_fn find = __atomic_load_n(&scan_find, __ATOMIC_ACQUIRE);
+	if (!find) {
+		scanner_use(SCANNER_AUTO);
+		find = __atomic_load_n(&scan_find, __ATOMIC_ACQUIRE);
+	}
+
+	if (find == scan_find_none) {
+		for (; p < end; p++)
+			scanner_step(s, *p);
+		return;
+	}
+
+	while (p < end) {
+		// Outside an instruction only "mu" and "do" can lead anywhere
+		if (s->state == SCAN_IDLE) {
+			p = find(p, end);
+			if (p == end)
+				break;
+		}
+		scanner_step(s, *p++);
+	}
+}
+
+void scanner_feed(scanner_t *s, const char *buf, size_t len)
+{
+	scanner_scan(s, buf, buf + len);
+}
+
+void scanner_finish(scanner_t *s)
+{
+	s->state = SCAN_IDLE;
+}
+
+/// Bytes read at a time by scanner_scan_stream()
+#define SCANNER_STREAM_CHUNK (64 * 1024)
+
+int scanner_scan_stream(scanner_t *s, const char *f_name)
+{
+	int use_stdin = (f_name == NULL || strcmp(f_name, "-") == 0);
+	int fd = use_stdin ? STDIN_FILENO : open(f_name, O_RDONLY);
+	int ret = 0;
+
+	if (fd < 0) {
+		perror("Failed to read file");
+		return -1;
+	}
+
+	char *buf = malloc(SCANNER_STREAM_CHUNK);
+	if (!buf) {
+		perror("Failed to allocate memory");
+		ret = -1;
+		goto close_fd;
+	}
+
+	for (;;) {
+		ssize_t n = read(fd, buf, SCANNER_STREAM_CHUNK);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("Failed to read file");
+			ret = -1;
+			break;
+		}
+		if (n == 0)
+			break;
+
+		STATS_COUNT("bytes_read", n);
+		scanner_feed(s, buf, n);
+	}
+
+	scanner_finish(s);
+	free(buf);
+
+close_fd:
+	if (!use_stdin)
+		close(fd);
+	return ret;
+}
+
+void scanner_scan_chunk(scanner_t *s, const char *begin, const char *stop,
+			const char *end)
+{
+	scanner_scan(s, begin, stop);
+
+	// Finish an instruction that straddles the cut, but never start one:
+	// anything starting at or after stop belongs to the next chunk
+	for (const char *p = stop; p < end && s->state != SCAN_IDLE; p++) {
+		if (!scanner_advance(s, *p))
+			s->state = SCAN_IDLE;
+	}
+	s->state = SCAN_IDLE;
+}
+
+void scanner_join(scanner_t *acc, const scanner_t *next)
+{
+	acc->part_one += next->part_one;
+	acc->part_two += next->part_two;
+
+	if (acc->enabled > 0)
+		acc->part_two += next->pending;
+	else if (acc->enabled < 0)
+		acc->pending += next->pending;
+
+	if (next->enabled >= 0)
+		acc->enabled = next->enabled;
+}
+
+/// One slice of the input and its summary
+typedef struct {
+	const char *begin;
+	const char *stop;
+	const char *end;
+	scanner_t summary;
+} scanner_job_t;
+
+static void *scanner_worker(void *arg)
+{
+	scanner_job_t *job = arg;
+
+	scanner_init_chunk(&job->summary);
+	scanner_scan_chunk(&job->summary, job->begin, job->stop, job->end);
+	return NULL;
+}
+
+int scanner_scan_parallel(scanner_t *s, const char *begin, const char *end,
+			  int threads)
+{
+	if (threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (threads <= 1 || end - begin < threads * 64) {
+		scanner_scan(s, begin, end);
+		return 0;
+	}
+
+	scanner_job_t *jobs = calloc(threads, sizeof(*jobs));
+	pthread_t *tids = malloc(sizeof(*tids) * threads);
+	if (!jobs || !tids) {
+		perror("ERROR: Failed to allocate worker state");
+		free(jobs);
+		free(tids);
+		return -1;
+	}
+
+	for (int i = 0; i < threads; i++) {
+		jobs[i].begin = begin + (end - begin) * i / threads;
+		jobs[i].stop = begin + (end - begin) * (i + 1) / threads;
+		jobs[i].end = end;
+	}
+
+	int started = 0;
+	for (; started < threads; started++) {
+		if (pthread_create(&tids[started], NULL, scanner_worker,
+				   &jobs[started]) != 0)
+			break;
+	}
+
+	for (int i = started; i < threads; i++)
+		scanner_worker(&jobs[i]);
+
+	// Prefix pass: each summary is resolved by the state the previous one left
+	for (int i = 0; i < threads; i++) {
+		if (i < started)
+			pthread_join(tids[i], NULL);
+		scanner_join(s, &jobs[i].summary);
+	}
+
+	free(jobs);
+	free(tids);
+	return 0;
+}
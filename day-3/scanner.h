@@ -0,0 +1,152 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <stddef.h> // For size_t
+
+/// Where the scanner is inside a (possibly partial) instruction
+typedef enum {
+	SCAN_IDLE, // Not inside an instruction
+	SCAN_M, // "m"
+	SCAN_MU, // "mu"
+	SCAN_MUL, // "mul"
+	SCAN_A, // "mul(" and 0-3 digits of the first operand
+	SCAN_B, // "mul(a," and 0-3 digits of the second operand
+	SCAN_D, // "d"
+	SCAN_DO, // "do"
+	SCAN_DO_OPEN, // "do("
+	SCAN_DON, // "don"
+	SCAN_DON_QUOTE, // "don'"
+	SCAN_DONT, // "don't"
+	SCAN_DONT_OPEN // "don't("
+} scan_state_t;
+
+/// Scanner state and running totals for both parts
+typedef struct {
+	scan_state_t state; // DFA state
+	int a; // First operand parsed so far
+	int b; // Second operand parsed so far
+	int digits; // Digits of the operand being parsed
+	int enabled; // Last do()/don't() seen: 1 enabled, 0 disabled, -1 not yet
+		     // known (chunk scans, until the chunk's first toggle)
+	long long part_one; // Sum of every valid mul()
+	long long part_two; // Sum of the mul()s seen while enabled
+	long long pending; // Sum of the mul()s seen while enabled was -1
+} scanner_t;
+
+/// Candidate search used by scanner_scan() to skip noise between instructions
+typedef enum {
+	SCANNER_AUTO, // Best one supported by the running CPU
+	SCANNER_SCALAR, // No prefilter, every byte goes through the DFA
+	SCANNER_SSE2, // Look for "mu"/"do" 16 bytes at a time
+	SCANNER_AVX2 // Look for "mu"/"do" 32 bytes at a time
+} scanner_impl_t;
+
+/**
+ * Forces the candidate search used by scanner_scan(). By default the best
+ * supported one is picked on first use; this is mostly for benchmarks.
+ *
+ * @param impl The implementation to use.
+ * @return 0 on success, -1 if the running CPU does not support it.
+ */
+int scanner_use(scanner_impl_t impl);
+
+/**
+ * Initializes a scanner: no partial instruction, mul()s enabled, zero totals.
+ *
+ * @param s Pointer to the scanner.
+ */
+void scanner_init(scanner_t *s);
+
+/**
+ * Scans corrupted memory for mul(a,b), do() and don't() in a single pass.
+ *
+ * A small DFA recognizes the instructions; nothing is copied, allocated or
+ * written back. Between instructions a vectorized search (see scanner_use())
+ * jumps straight to the next "mu" or "do", so noise is skipped 16 or 32 bytes
+ * at a time. Operands must be 1 to 3 digits. Both parts are computed at once:
+ * part one sums every mul(), part two only those seen while enabled.
+ *
+ * @param s Scanner holding the state and totals, see scanner_init().
+ * @param begin First byte of the input.
+ * @param end One past the last byte of the input.
+ */
+void scanner_scan(scanner_t *s, const char *begin, const char *end);
+
+/**
+ * Pushes the next piece of an input through the scanner. Pieces may be cut
+ * anywhere, even inside an instruction: the partial match is kept in s, so
+ * "mul(12," fed now and "34)" fed next still count. Same as scanner_scan().
+ *
+ * @param s Scanner, see scanner_init().
+ * @param buf The bytes.
+ * @param len Number of bytes.
+ */
+void scanner_feed(scanner_t *s, const char *buf, size_t len);
+
+/**
+ * Ends the input: an instruction still incomplete is dropped, and s is
+ * ready to be fed another input with the same totals and enabled state.
+ *
+ * @param s Scanner, see scanner_init().
+ */
+void scanner_finish(scanner_t *s);
+
+/**
+ * Scans a file or stdin through scanner_feed() with one fixed size buffer,
+ * so memory stays constant however long the input is, and pipes or sockets
+ * work as well as regular files. Calls scanner_finish() at the end.
+ *
+ * @param s Scanner to add the totals to, see scanner_init().
+ * @param f_name The file to read, or NULL / "-" for stdin.
+ * @return 0 on success, -1 on failure.
+ */
+int scanner_scan_stream(scanner_t *s, const char *f_name);
+
+/**
+ * Initializes a scanner for one chunk of a larger input. The enabled state
+ * on entry is unknown, so mul()s before the chunk's first do()/don't() are
+ * kept apart in `pending` until scanner_join() resolves them.
+ *
+ * @param s Pointer to the scanner.
+ */
+void scanner_init_chunk(scanner_t *s);
+
+/**
+ * Scans the instructions that start in [begin, stop). An instruction that
+ * starts before stop but ends after it is completed by reading on towards
+ * end, so chunks can be cut anywhere and still add up to a serial scan.
+ *
+ * @param s Scanner, see scanner_init_chunk().
+ * @param begin First byte of the chunk.
+ * @param stop One past the last byte where an instruction may start.
+ * @param end One past the last byte that may be read.
+ */
+void scanner_scan_chunk(scanner_t *s, const char *begin, const char *stop,
+			const char *end);
+
+/**
+ * Appends the summary of the chunk that follows acc. Pending mul()s of next
+ * are resolved by the state acc ends in, and acc takes over next's final
+ * state. The operation is associative, so summaries can be combined in any
+ * grouping as long as their order is kept.
+ *
+ * @param acc Scanner or summary covering everything before next.
+ * @param next Summary of the following chunk.
+ */
+void scanner_join(scanner_t *acc, const scanner_t *next);
+
+/**
+ * Scans an input on several threads. Each thread summarizes one slice,
+ * then a prefix pass over the summaries carries the do()/don't() state from
+ * slice to slice, so the totals match scanner_scan() exactly.
+ *
+ * @param s Scanner to add the totals to, see scanner_init().
+ * @param begin First byte of the input.
+ * @param end One past the last byte of the input.
+ * @param threads Number of threads, 0 for one per online CPU.
+ * @return 0 on success, -1 on failure.
+ */
+int scanner_scan_parallel(scanner_t *s, const char *begin, const char *end,
+			  int threads);
+
+#endif // SCANNER_H
@@ -0,0 +1,252 @@
+#include "scanner.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+
+static scanner_t scan_str(const char *str)
+{
+	scanner_t s;
+	scanner_init(&s);
+	scanner_scan(&s, str, str + strlen(str));
+	return s;
+}
+
+void test_sample(void)
+{
+	scanner_t s = scan_str(
+		"xmul(2,4)&mul[3,7]!^don't()_mul(5,5)+mul(32,64](mul(11,8)undo()?mul(8,5))");
+	assert(s.part_one == 161);
+	assert(s.part_two == 48);
+	printf("test_sample passed.\n");
+}
+
+void test_enable_toggles(void)
+{
+	// The cases from test.input, with their part two results
+	static const struct {
+		const char *input;
+		long long expected;
+	} cases[] = {
+		{ "", 0 },
+		{ "don't()mul(3,3)mul(4,4)", 0 },
+		{ "do()mul(3,3)mul(4,4)don't()", 25 },
+		{ "don't()do()mul(3,3)mul(4,4)don't()", 25 },
+		{ "abc!@#do()xyzdon't()123", 0 },
+		{ "do()don't()do()don't()", 0 },
+		{ "mul(1)do()mul(2,3,4)don't()mul(a,b)", 0 },
+		{ "mul(2,2)don't()do()mul(3,3)", 13 },
+		{ "do()mul(2,2)don't()don't()mul(3,3)do()mul(4,4)", 20 },
+		{ "do()do()mul(2,2)don't()mul(3,3)", 4 },
+	};
+
+	for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+		assert(scan_str(cases[i].input).part_two == cases[i].expected);
+	printf("test_enable_toggles passed.\n");
+}
+
+void test_operands(void)
+{
+	assert(scan_str("mul(123,456)").part_one == 123 * 456);
+	assert(scan_str("mul(1234,5)").part_one == 0);
+	assert(scan_str("mul(12,3456)").part_one == 0);
+	assert(scan_str("mul(,5)mul(5,)mul( 1,2)").part_one == 0);
+	assert(scan_str("mulmul(2,3)mmul(4,5)").part_one == 26);
+	assert(scan_str("mul(2,3mul(4,5)").part_one == 20);
+	assert(scan_str("dodon't()mul(2,2)").part_two == 0);
+	printf("test_operands passed.\n");
+}
+
+void test_chunk_join(void)
+{
+	static const char alphabet[] = "mul(),don't1234567890x";
+	char buf[128];
+
+	srand(42);
+	for (int iter = 0; iter < 2000; iter++) {
+		size_t n = rand() % sizeof(buf);
+		for (size_t i = 0; i < n; i++)
+			buf[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+
+		scanner_t serial;
+		scanner_init(&serial);
+		scanner_scan(&serial, buf, buf + n);
+
+		// Every two-way cut must add up to the serial scan
+		for (size_t cut = 0; cut <= n; cut++) {
+			scanner_t acc, left, right;
+
+			scanner_init_chunk(&left);
+			scanner_scan_chunk(&left, buf, buf + cut, buf + n);
+			scanner_init_chunk(&right);
+			scanner_scan_chunk(&right, buf + cut, buf + n, buf + n);
+
+			scanner_init(&acc);
+			scanner_join(&acc, &left);
+			scanner_join(&acc, &right);
+			assert(acc.part_one == serial.part_one);
+			assert(acc.part_two == serial.part_two);
+			assert(acc.enabled == serial.enabled);
+
+			// Joining the summaries first must give the same result
+			scanner_join(&left, &right);
+			scanner_init(&acc);
+			scanner_join(&acc, &left);
+			assert(acc.part_two == serial.part_two);
+		}
+	}
+	printf("test_chunk_join passed.\n");
+}
+
+void test_parallel(void)
+{
+	static const char *pieces[] = { "mul(12,34)", "do()", "don't()",
+					"xmu", "mul(1,", "d", "noise " };
+	char buf[64 * 1024];
+	size_t n = 0;
+
+	srand(7);
+	while (n + 16 < sizeof(buf)) {
+		const char *p = pieces[rand() % 7];
+		memcpy(buf + n, p, strlen(p));
+		n += strlen(p);
+	}
+
+	scanner_t serial;
+	scanner_init(&serial);
+	scanner_scan(&serial, buf, buf + n);
+
+	for (int threads = 1; threads <= 9; threads++) {
+		scanner_t s;
+		scanner_init(&s);
+		assert(scanner_scan_parallel(&s, buf, buf + n, threads) == 0);
+		assert(s.part_one == serial.part_one);
+		assert(s.part_two == serial.part_two);
+	}
+	printf("test_parallel passed.\n");
+}
+
+void test_feed_splits(void)
+{
+	const char *text =
+		"xmul(2,4)&mul[3,7]!^don't()_mul(5,5)+mul(32,64](mul(11,8)undo()?mul(8,5))";
+	size_t len = strlen(text);
+	scanner_t whole = scan_str(text);
+
+	// Every single cut, including inside "mul(", operands and "don't()"
+	for (size_t cut = 0; cut <= len; cut++) {
+		scanner_t s;
+		scanner_init(&s);
+		scanner_feed(&s, text, cut);
+		scanner_feed(&s, text + cut, len - cut);
+		scanner_finish(&s);
+		assert(s.part_one == whole.part_one);
+		assert(s.part_two == whole.part_two);
+	}
+
+	// One byte at a time
+	scanner_t s;
+	scanner_init(&s);
+	for (size_t i = 0; i < len; i++)
+		scanner_feed(&s, text + i, 1);
+	scanner_finish(&s);
+	assert(s.part_one == whole.part_one);
+	assert(s.part_two == whole.part_two);
+
+	scanner_init(&s);
+	scanner_feed(&s, "mul(12,", 7);
+	scanner_feed(&s, "", 0);
+	scanner_feed(&s, "34)", 3);
+	assert(s.part_one == 408);
+	printf("test_feed_splits passed.\n");
+}
+
+void test_finish(void)
+{
+	scanner_t s;
+	scanner_init(&s);
+
+	// An instruction left open by one input does not complete in the next
+	scanner_feed(&s, "mul(2,3)mul(12,", 15);
+	scanner_finish(&s);
+	scanner_feed(&s, "34)", 3);
+	scanner_finish(&s);
+	assert(s.part_one == 6);
+
+	// The enabled state carries over, like the totals
+	scanner_feed(&s, "don't()", 7);
+	scanner_finish(&s);
+	scanner_feed(&s, "mul(1,1)", 8);
+	scanner_finish(&s);
+	assert(s.part_one == 7);
+	assert(s.part_two == 6);
+	printf("test_finish passed.\n");
+}
+
+void test_stream(void)
+{
+	char path[] = "/tmp/scanner_tests.XXXXXX";
+	size_t len = 3 * 64 * 1024 + 17; // A few reads, the last one partial
+	char *text = malloc(len);
+	assert(text);
+
+	// Instructions and noise at odd offsets, so some cross read boundaries
+	static const char *const pieces[] = { "mul(12,34)", "do()", "don't()",
+					      "mul(7,8", "xmul(999,1)", "?" };
+	size_t used = 0;
+	unsigned seed = 1;
+	while (used < len) {
+		seed = seed * 1103515245 + 12345;
+		const char *piece = pieces[(seed >> 16) % 6];
+		size_t n = strlen(piece);
+		if (n > len - used)
+			n = len - used;
+		memcpy(text + used, piece, n);
+		used += n;
+	}
+
+	int fd = mkstemp(path);
+	assert(fd >= 0);
+	assert(write(fd, text, len) == (ssize_t)len);
+	close(fd);
+
+	scanner_t whole, s;
+	scanner_init(&whole);
+	scanner_scan(&whole, text, text + len);
+
+	scanner_init(&s);
+	assert(scanner_scan_stream(&s, path) == 0);
+	assert(s.part_one == whole.part_one);
+	assert(s.part_two == whole.part_two);
+	assert(s.part_one > 0 && s.part_two > 0);
+
+	assert(scanner_scan_stream(&s, "/nonexistent/scanner") == -1);
+
+	unlink(path);
+	free(text);
+	printf("test_stream passed.\n");
+}
+
+int main(void)
+{
+	static const scanner_impl_t impls[] = { SCANNER_SCALAR, SCANNER_SSE2,
+						SCANNER_AVX2 };
+
+	for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+		if (scanner_use(impls[i]) < 0)
+			continue;
+
+		test_sample();
+		test_enable_toggles();
+		test_operands();
+		test_chunk_join();
+		test_parallel();
+		test_feed_splits();
+		test_finish();
+		test_stream();
+	}
+
+	printf("All tests passed.\n");
+	return 0;
+}
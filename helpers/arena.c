@@ -0,0 +1,153 @@
+#include "arena.h"
+#include "stats.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Alignment of every allocation, enough for any scalar type
+#define ARENA_ALIGN 16
+
+/// Offset in b->data where an aligned allocation can start
+static size_t arena_aligned_used(const arena_block_t *b)
+{
+	uintptr_t p = (uintptr_t)(b->data + b->used);
+	uintptr_t aligned = (p + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1);
+	return b->used + (aligned - p);
+}
+
+/// Make a block with room for size aligned bytes the head, reusing a spare one if it fits
+static void arena_new_block(arena_t *a, size_t size)
+{
+	arena_block_t *b = NULL;
+
+	if (a->spare && a->spare->size >= size + ARENA_ALIGN) {
+		b = a->spare;
+		a->spare = b->prev;
+	} else {
+		size_t bytes = size + ARENA_ALIGN > a->block_size ?
+				       size + ARENA_ALIGN :
+				       a->block_size;
+
+		b = malloc(sizeof(*b) + bytes);
+		if (!b) {
+			fprintf(stderr, "ERROR: Failed to allocate arena block\n");
+			exit(EXIT_FAILURE);
+		}
+		b->size = bytes;
+		a->mallocs++;
+		STATS_COUNT("arena_blocks", 1);
+	}
+
+	b->used = 0;
+	b->prev = a->head;
+	a->head = b;
+}
+
+static void *arena_vec_realloc(void *ctx, void *ptr, size_t old_size,
+			       size_t new_size)
+{
+	return arena_realloc(ctx, ptr, old_size, new_size);
+}
+
+static void arena_vec_free(void *ctx, void *ptr)
+{
+	(void)ctx;
+	(void)ptr; // Returned on the next reset
+}
+
+void arena_init(arena_t *a, size_t block_size)
+{
+	memset(a, 0, sizeof(*a));
+	a->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK;
+	a->vec_alloc.realloc = arena_vec_realloc;
+	a->vec_alloc.free = arena_vec_free;
+	a->vec_alloc.ctx = a;
+}
+
+static void arena_free_chain(arena_block_t *b)
+{
+	while (b) {
+		arena_block_t *prev = b->prev;
+		free(b);
+		b = prev;
+	}
+}
+
+void arena_free(arena_t *a)
+{
+	if (!a)
+		return;
+
+	arena_free_chain(a->head);
+	arena_free_chain(a->spare);
+	a->head = a->spare = NULL;
+	a->last = NULL;
+}
+
+void *arena_alloc(arena_t *a, size_t size)
+{
+	arena_block_t *b = a->head;
+	size_t start = b ? arena_aligned_used(b) : 0;
+
+	if (!b || start + size > b->size) {
+		arena_new_block(a, size);
+		b = a->head;
+		start = arena_aligned_used(b);
+	}
+
+	b->used = start + size;
+	a->last = b->data + start;
+	a->allocs++;
+	return a->last;
+}
+
+void *arena_realloc(arena_t *a, void *ptr, size_t old_size, size_t new_size)
+{
+	if (!ptr)
+		return arena_alloc(a, new_size);
+
+	// The latest allocation ends at head->used, so it can move its end freely
+	if (ptr == a->last) {
+		arena_block_t *b = a->head;
+		size_t start = (char *)ptr - b->data;
+
+		if (start + new_size <= b->size) {
+			b->used = start + new_size;
+			return ptr;
+		}
+	}
+
+	if (new_size <= old_size)
+		return ptr;
+
+	void *p = arena_alloc(a, new_size);
+	memcpy(p, ptr, old_size);
+	return p;
+}
+
+arena_mark_t arena_mark(const arena_t *a)
+{
+	arena_mark_t mark = { a->head, a->head ? a->head->used : 0 };
+	return mark;
+}
+
+void arena_reset(arena_t *a, arena_mark_t mark)
+{
+	// Park the blocks filled after the mark on the spare list
+	while (a->head && a->head != mark.block) {
+		arena_block_t *b = a->head;
+		a->head = b->prev;
+		b->prev = a->spare;
+		a->spare = b;
+	}
+
+	if (a->head)
+		a->head->used = mark.used;
+	a->last = NULL;
+}
+
+vec_t *arena_vec_create(arena_t *a, vec_type_t type, size_t cap)
+{
+	return vec_create_in(type, cap, &a->vec_alloc);
+}
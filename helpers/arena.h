@@ -0,0 +1,106 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h> // For size_t
+#include "vec.h"
+
+/// Default size of each block the arena carves allocations from
+#define ARENA_DEFAULT_BLOCK (1 << 20)
+
+/// One malloc'd block, allocations are bumped from data
+typedef struct arena_block {
+	struct arena_block *prev; // Block filled before this one
+	size_t size; // Usable bytes in data
+	size_t used; // Bytes handed out so far
+	char data[];
+} arena_block_t;
+
+/// Bump allocator: many small allocations, released all at once
+typedef struct {
+	arena_block_t *head; // Block currently being filled
+	arena_block_t *spare; // Blocks released by arena_reset(), kept for reuse
+	size_t block_size; // Size of a regular block
+	void *last; // Most recent allocation, the only one that can grow in place
+	size_t allocs; // Allocations served
+	size_t mallocs; // Blocks obtained from malloc
+	vec_allocator_t vec_alloc; // Hook for vec_create_in(), see arena_vec_create()
+} arena_t;
+
+/// A point in an arena's history to return to with arena_reset()
+typedef struct {
+	arena_block_t *block;
+	size_t used;
+} arena_mark_t;
+
+/**
+ * Initializes an empty arena. No memory is taken until the first allocation.
+ *
+ * The arena must not be moved after this call, vectors created in it keep a
+ * pointer to it.
+ *
+ * @param a Pointer to the arena.
+ * @param block_size Size of each block, 0 for `ARENA_DEFAULT_BLOCK`.
+ */
+void arena_init(arena_t *a, size_t block_size);
+
+/**
+ * Frees every block of the arena, invalidating all its allocations.
+ *
+ * @param a Pointer to the arena.
+ */
+void arena_free(arena_t *a);
+
+/**
+ * Allocates `size` bytes aligned for any type. Never returns NULL, running
+ * out of memory is fatal like in vec_t.
+ *
+ * @param a Pointer to the arena.
+ * @param size Number of bytes.
+ * @return Pointer to the new memory, valid until it is reset past or freed.
+ */
+void *arena_alloc(arena_t *a, size_t size);
+
+/**
+ * Resizes an allocation. The most recent allocation grows or shrinks in
+ * place while its block has room, anything else is copied to a new
+ * allocation and the old one is simply abandoned.
+ *
+ * @param a Pointer to the arena.
+ * @param ptr Allocation to resize, or NULL to allocate.
+ * @param old_size Current size of ptr.
+ * @param new_size Requested size.
+ * @return Pointer to the resized memory.
+ */
+void *arena_realloc(arena_t *a, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * Records the current fill level of the arena.
+ *
+ * @param a Pointer to the arena.
+ * @return A mark to pass to arena_reset().
+ */
+arena_mark_t arena_mark(const arena_t *a);
+
+/**
+ * Releases everything allocated since `mark` was taken in one step. Blocks
+ * that become unused are kept for the next allocations instead of being
+ * returned to malloc. A zeroed mark resets the whole arena.
+ *
+ * @param a Pointer to the arena.
+ * @param mark A mark taken on this arena, not older than a previous reset.
+ */
+void arena_reset(arena_t *a, arena_mark_t mark);
+
+/**
+ * Creates a vector whose struct and storage live in the arena. It grows in
+ * place while it is the most recent allocation. vec_destroy() is allowed
+ * but frees nothing, the memory goes back with the next arena_reset().
+ *
+ * @param a Pointer to the arena.
+ * @param type The type of elements to store in the vector.
+ * @param cap Initial capacity.
+ * @return Pointer to the newly created vector.
+ */
+vec_t *arena_vec_create(arena_t *a, vec_type_t type, size_t cap);
+
+#endif // ARENA_H
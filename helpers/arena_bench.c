@@ -0,0 +1,116 @@
+#include "arena.h"
+#include "vec.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BATCH 4096 // Reports between two arena resets
+
+/// Heap allocator that counts the calls reaching malloc/realloc/free
+static size_t heap_calls;
+
+static void *counting_realloc(void *ctx, void *ptr, size_t old_size,
+			      size_t new_size)
+{
+	(void)ctx;
+	(void)old_size;
+	heap_calls++;
+	return realloc(ptr, new_size);
+}
+
+static void counting_free(void *ctx, void *ptr)
+{
+	(void)ctx;
+	heap_calls++;
+	free(ptr);
+}
+
+static const vec_allocator_t counting_heap = { counting_realloc,
+					       counting_free, NULL };
+
+/// The old day-2 shape: one small vector per report, built and dropped
+static long long run_heap(size_t reports, const int *levels)
+{
+	long long sum = 0;
+
+	for (size_t r = 0; r < reports; r++) {
+		vec_t *v = vec_create_in(TYPE_INT, 0, &counting_heap);
+		for (int i = 0; i < 8; i++)
+			vec_push_back(v, &levels[(r + i) & 1023]);
+		sum += *(int *)vec_at(v, 7);
+		vec_destroy(v);
+	}
+
+	return sum;
+}
+
+/// Same work in an arena, whole batches released with one reset
+static long long run_arena(size_t reports, const int *levels, arena_t *a)
+{
+	arena_mark_t mark = arena_mark(a);
+	long long sum = 0;
+
+	for (size_t r = 0; r < reports; r++) {
+		vec_t *v = arena_vec_create(a, TYPE_INT, 0);
+		for (int i = 0; i < 8; i++)
+			vec_push_back(v, &levels[(r + i) & 1023]);
+		sum += *(int *)vec_at(v, 7);
+
+		if ((r + 1) % BATCH == 0)
+			arena_reset(a, mark);
+	}
+
+	arena_reset(a, mark);
+	return sum;
+}
+
+/// One timed build, heap or arena, and its checksum
+typedef struct {
+	size_t reports;
+	const int *levels;
+	arena_t *arena; // NULL: the heap
+	long long sum;
+} arena_job_t;
+
+static void run_job(void *arg)
+{
+	arena_job_t *job = arg;
+
+	if (job->arena) {
+		job->sum = run_arena(job->reports, job->levels, job->arena);
+	} else {
+		heap_calls = 0; // Left holding the calls of the last round
+		job->sum = run_heap(job->reports, job->levels);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	size_t reports = argc > 1 ? strtoul(argv[1], NULL, 10) :
+				    bench_scaled(10000000);
+	int levels[1024];
+	unsigned state = 42;
+	arena_t a;
+
+	for (int i = 0; i < 1024; i++)
+		levels[i] = bench_rand(&state) % 100;
+
+	arena_init(&a, 0);
+
+	arena_job_t heap = { reports, levels, NULL, 0 };
+	arena_job_t in_arena = { reports, levels, &a, 0 };
+	double t_heap = bench_run("arena/heap_vec", 0, run_job, &heap);
+	double t_arena = bench_run("arena/arena_vec", 0, run_job, &in_arena);
+
+	if (heap.sum != in_arena.sum) {
+		fprintf(stderr, "ERROR: arena sum %lld, heap sum %lld\n",
+			in_arena.sum, heap.sum);
+		return 1;
+	}
+
+	bench_note("%-28s %zu heap calls vs %zu block mallocs, %.1fx faster",
+		   "arena", heap_calls, a.mallocs, t_heap / t_arena);
+
+	arena_free(&a);
+	return 0;
+}
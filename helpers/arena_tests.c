@@ -0,0 +1,168 @@
+#include "arena.h"
+#include "vec.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+void test_alloc_align(void)
+{
+	arena_t a;
+	arena_init(&a, 256);
+
+	for (size_t size = 1; size < 100; size++) {
+		char *p = arena_alloc(&a, size);
+		assert(((uintptr_t)p & 15) == 0);
+		memset(p, 0xab, size);
+	}
+
+	// Larger than a block gets a block of its own
+	char *big = arena_alloc(&a, 10000);
+	memset(big, 0, 10000);
+	assert(a.allocs == 100);
+
+	arena_free(&a);
+	printf("test_alloc_align passed.\n");
+}
+
+void test_realloc_in_place(void)
+{
+	arena_t a;
+	arena_init(&a, 1024);
+
+	char *p = arena_alloc(&a, 16);
+	strcpy(p, "arena");
+	assert(arena_realloc(&a, p, 16, 512) == p);
+	assert(strcmp(p, "arena") == 0);
+
+	// No longer the latest allocation: moved and copied
+	arena_alloc(&a, 8);
+	char *q = arena_realloc(&a, p, 512, 600);
+	assert(q != p && strcmp(q, "arena") == 0);
+
+	arena_free(&a);
+	printf("test_realloc_in_place passed.\n");
+}
+
+void test_mark_reset(void)
+{
+	arena_t a;
+	arena_init(&a, 1024);
+
+	arena_alloc(&a, 100);
+	arena_mark_t mark = arena_mark(&a);
+	char *first = arena_alloc(&a, 100);
+
+	for (int round = 0; round < 1000; round++) {
+		arena_reset(&a, mark);
+		char *p = arena_alloc(&a, 100);
+		assert(p == first);
+		for (int i = 0; i < 50; i++) // Spills into more blocks
+			arena_alloc(&a, 100);
+	}
+
+	// Blocks freed by reset are reused, not malloc'd again
+	assert(a.mallocs <= 8);
+
+	arena_reset(&a, (arena_mark_t){ 0 });
+	assert(a.head == NULL);
+
+	arena_free(&a);
+	printf("test_mark_reset passed.\n");
+}
+
+void test_vec_in_arena(void)
+{
+	arena_t a;
+	arena_init(&a, 0);
+
+	arena_mark_t mark = arena_mark(&a);
+	for (int round = 0; round < 3; round++) {
+		vec_t *outer = arena_vec_create(&a, TYPE_VEC, 4);
+
+		for (int r = 0; r < 100; r++) {
+			vec_t *row = arena_vec_create(&a, TYPE_INT, 1);
+			for (int i = 0; i < r; i++)
+				vec_push_back(row, &i);
+			vec_push_back(outer, row);
+		}
+
+		for (int r = 0; r < 100; r++) {
+			vec_t *row = vec_at(outer, r);
+			assert(vec_size(row) == (size_t)r);
+			for (int i = 0; i < r; i++)
+				assert(*(int *)vec_at(row, i) == i);
+		}
+
+		vec_destroy(outer); // Frees nothing, allowed anyway
+		arena_reset(&a, mark);
+	}
+
+	assert(a.mallocs == 1);
+	arena_free(&a);
+	printf("test_vec_in_arena passed.\n");
+}
+
+void test_vec_mixed_allocators(void)
+{
+	arena_t a;
+	arena_init(&a, 0);
+	int nums[] = { 1, 2, 3, 4, 5 };
+
+	arena_mark_t mark = arena_mark(&a);
+	vec_t *heap = vec_create(TYPE_INT);
+	vec_t *in_arena = arena_vec_create(&a, TYPE_INT, 4);
+	vec_push_n(heap, nums, 2);
+	vec_push_n(in_arena, nums, 5);
+
+	// Each side keeps its own allocator, whichever way the contents go
+	vec_swap(heap, in_arena);
+	assert(heap->alloc == NULL && in_arena->alloc == &a.vec_alloc);
+	assert(vec_size(heap) == 5 && vec_size(in_arena) == 2);
+	assert(*(int *)vec_at(heap, 4) == 5 && *(int *)vec_at(in_arena, 1) == 2);
+
+	vec_move(in_arena, heap);
+	assert(in_arena->alloc == &a.vec_alloc && vec_size(in_arena) == 5);
+	assert(vec_size(heap) == 0 && heap->data == NULL);
+
+	vec_move(heap, in_arena);
+	assert(heap->alloc == NULL && vec_size(heap) == 5);
+
+	// Nested vectors follow the destination allocator too
+	vec_t *outer = arena_vec_create(&a, TYPE_VEC, 2);
+	vec_t *row = arena_vec_create(&a, TYPE_INT, 2);
+	vec_push_n(row, nums, 3);
+	vec_push_back(outer, row);
+	vec_t *heap_outer = vec_create(TYPE_VEC);
+	vec_move(heap_outer, outer);
+	assert(((vec_t *)vec_at(heap_outer, 0))->alloc == NULL);
+
+	vec_destroy(in_arena);
+	vec_destroy(outer);
+
+	// Nothing on the heap points into the arena once it is reset
+	arena_reset(&a, mark);
+	vec_t *arena_fill = arena_vec_create(&a, TYPE_INT, 64);
+	memset(arena_fill->data, 0xff, 64 * sizeof(int));
+	for (int i = 0; i < 5; i++)
+		assert(*(int *)vec_at(heap, i) == nums[i]);
+	assert(*(int *)vec_at(vec_at(heap_outer, 0), 2) == 3);
+
+	vec_destroy(heap);
+	vec_destroy(heap_outer);
+	arena_free(&a);
+	printf("test_vec_mixed_allocators passed.\n");
+}
+
+int main(void)
+{
+	test_alloc_align();
+	test_realloc_in_place();
+	test_mark_reset();
+	test_vec_in_arena();
+	test_vec_mixed_allocators();
+
+	printf("All tests passed.\n");
+	return 0;
+}
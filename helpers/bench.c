@@ -0,0 +1,273 @@
+#include "bench.h"
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+double bench_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/// Harness settings from the environment, read on first use
+static struct {
+	int loaded;
+	int warmup;
+	int repeats;
+	int json;
+	double scale;
+	const char *tag;
+} bench_cfg;
+
+static int bench_env_int(const char *var, int def, int min)
+{
+	const char *v = getenv(var);
+	int n = v ? atoi(v) : def;
+	return n < min ? min : n;
+}
+
+static void bench_load_config(void)
+{
+	if (bench_cfg.loaded)
+		return;
+
+	const char *format = getenv("BENCH_FORMAT");
+	const char *scale = getenv("BENCH_SCALE");
+
+	bench_cfg.warmup = bench_env_int("BENCH_WARMUP", 1, 0);
+	bench_cfg.repeats = bench_env_int("BENCH_REPEATS", 5, 1);
+	bench_cfg.json = format && strcmp(format, "json") == 0;
+	bench_cfg.scale = scale ? atof(scale) : 1.0;
+	bench_cfg.tag = getenv("BENCH_TAG");
+	bench_cfg.loaded = 1;
+}
+
+/// Print s as a JSON string
+static void bench_json_str(const char *s)
+{
+	putchar('"');
+	for (; *s; s++) {
+		if (*s == '"' || *s == '\\')
+			putchar('\\');
+		if ((unsigned char)*s >= ' ')
+			putchar(*s);
+	}
+	putchar('"');
+}
+
+/// One result in the configured format; throughput is taken from the median
+static void bench_emit(const char *name, size_t bytes, int repeats, double min,
+		       double median, double p99)
+{
+	double gbps = bytes && median > 0 ? bytes / median / 1e9 : 0;
+
+	if (bench_cfg.json) {
+		printf("{\"name\":");
+		bench_json_str(name);
+		if (bench_cfg.tag) {
+			printf(",\"tag\":");
+			bench_json_str(bench_cfg.tag);
+		}
+		printf(",\"bytes\":%zu,\"repeats\":%d,\"min\":%.9f,"
+		       "\"median\":%.9f,\"p99\":%.9f,\"gbps\":%.6f}\n",
+		       bytes, repeats, min, median, p99, gbps);
+	} else if (repeats > 1) {
+		printf("%-28s %12zu bytes min %10.6f s median %10.6f s p99 %10.6f s",
+		       name, bytes, min, median, p99);
+		if (bytes)
+			printf(" %8.3f GB/s", gbps);
+		putchar('\n');
+	} else if (bytes) {
+		printf("%-28s %12zu bytes %10.6f s %8.3f GB/s\n", name, bytes,
+		       min, gbps);
+	} else {
+		printf("%-28s %10.6f s\n", name, min);
+	}
+	fflush(stdout);
+}
+
+void bench_report(const char *name, size_t bytes, double secs)
+{
+	bench_load_config();
+	bench_emit(name, bytes, 1, secs, secs, secs);
+}
+
+static int bench_compare_double(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+double bench_report_samples(const char *name, size_t bytes, double *samples,
+			    size_t n)
+{
+	assert(n > 0 && "No samples to report");
+	bench_load_config();
+
+	qsort(samples, n, sizeof(double), bench_compare_double);
+
+	double median = n % 2 ? samples[n / 2] :
+				(samples[n / 2 - 1] + samples[n / 2]) / 2;
+	size_t p99 = (99 * n + 99) / 100 - 1; // Nearest rank
+	bench_emit(name, bytes, (int)n, samples[0], median, samples[p99]);
+	return median;
+}
+
+double bench_run(const char *name, size_t bytes, void (*fn)(void *arg), void *arg)
+{
+	bench_load_config();
+
+	int n = bench_cfg.repeats;
+	double *samples = malloc(sizeof(double) * n);
+	if (!samples) {
+		fprintf(stderr, "ERROR: Failed to allocate benchmark samples\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int i = 0; i < bench_cfg.warmup; i++)
+		fn(arg);
+
+	for (int i = 0; i < n; i++) {
+		double t0 = bench_now();
+		fn(arg);
+		samples[i] = bench_now() - t0;
+	}
+
+	double median = bench_report_samples(name, bytes, samples, n);
+	free(samples);
+	return median;
+}
+
+void bench_note(const char *fmt, ...)
+{
+	FILE *out;
+	va_list ap;
+
+	bench_load_config();
+	out = bench_cfg.json ? stderr : stdout;
+
+	va_start(ap, fmt);
+	vfprintf(out, fmt, ap);
+	va_end(ap);
+	fputc('\n', out);
+}
+
+size_t bench_scaled(size_t n)
+{
+	bench_load_config();
+
+	double scaled = n * bench_cfg.scale;
+	return scaled < 1 ? 1 : (size_t)scaled;
+}
+
+unsigned bench_rand(unsigned *state)
+{
+	unsigned x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+char *bench_gen_day1(size_t lines, unsigned seed, size_t *len)
+{
+	const size_t line_len = 14; // "ddddd   ddddd\n"
+	unsigned state = seed ? seed : 1;
+	char *buf = malloc(lines * line_len + 1);
+
+	if (!buf) {
+		fprintf(stderr, "ERROR: Failed to allocate synthetic input\n");
+		exit(EXIT_FAILURE);
+	}
+
+	char *p = buf;
+	for (size_t i = 0; i < lines; i++) {
+		unsigned a = 10000 + bench_rand(&state) % 90000;
+		unsigned b = 10000 + bench_rand(&state) % 90000;
+		p += sprintf(p, "%05u   %05u\n", a, b);
+	}
+
+	*len = p - buf;
+	return buf;
+}
+
+char *bench_gen_day2(size_t reports, unsigned seed, size_t *len)
+{
+	const size_t max_line = 8 * 4; // Up to 8 levels of "ddd "
+	unsigned state = seed ? seed : 1;
+	char *buf = malloc(reports * max_line + 1);
+
+	if (!buf) {
+		fprintf(stderr, "ERROR: Failed to allocate synthetic input\n");
+		exit(EXIT_FAILURE);
+	}
+
+	char *p = buf;
+	for (size_t i = 0; i < reports; i++) {
+		int n = 5 + bench_rand(&state) % 4;
+		int dir = bench_rand(&state) & 1 ? 1 : -1;
+		int level = 20 + bench_rand(&state) % 60;
+
+		for (int j = 0; j < n; j++) {
+			p += sprintf(p, j ? " %d" : "%d", level);
+
+			unsigned r = bench_rand(&state) % 16;
+			int step = 1 + r % 3;
+			if (r == 0)
+				step = 0; // Repeated level
+			else if (r == 1)
+				step = -step; // Direction change
+			else if (r == 2)
+				step = 5; // Too big a jump
+			level += dir * step;
+		}
+		*p++ = '\n';
+	}
+	*p = '\0';
+
+	*len = p - buf;
+	return buf;
+}
+
+char *bench_gen_day3(size_t bytes, size_t spacing, unsigned seed, size_t *len)
+{
+	unsigned state = seed ? seed : 1;
+	char *buf = malloc(bytes + 16);
+
+	if (!buf) {
+		fprintf(stderr, "ERROR: Failed to allocate synthetic input\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (!spacing)
+		spacing = 1;
+
+	char *p = buf;
+	while ((size_t)(p - buf) < bytes) {
+		if (bench_rand(&state) % spacing) {
+			*p++ = ' ' + bench_rand(&state) % 95; // Printable noise
+			continue;
+		}
+
+		switch (bench_rand(&state) % 4) {
+		case 0:
+			p += sprintf(p, "do()");
+			break;
+		case 1:
+			p += sprintf(p, "don't()");
+			break;
+		default:
+			p += sprintf(p, "mul(%u,%u)", bench_rand(&state) % 1000,
+				     bench_rand(&state) % 1000);
+			break;
+		}
+	}
+	*p = '\0';
+
+	*len = p - buf;
+	return buf;
+}
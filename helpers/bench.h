@@ -0,0 +1,113 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h> // For size_t
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ *
+ * @return Seconds since an arbitrary fixed point.
+ */
+double bench_now(void);
+
+/**
+ * Prints one benchmark result line with throughput, for a kernel timed once
+ * by the caller. Follows `BENCH_FORMAT` like bench_run().
+ *
+ * @param name Name of the measured kernel.
+ * @param bytes Number of input bytes processed, 0 if not meaningful.
+ * @param secs Elapsed time in seconds.
+ */
+void bench_report(const char *name, size_t bytes, double secs);
+
+/**
+ * Times a kernel over several rounds and reports min, median and p99.
+ *
+ * `fn` runs untimed `BENCH_WARMUP` times (default 1), then timed
+ * `BENCH_REPEATS` times (default 5). With `BENCH_FORMAT=json` each result is
+ * printed as one JSON object per line, tagged with `BENCH_TAG` if set, so
+ * runs can be collected and compared across commits.
+ *
+ * @param name Name of the measured kernel.
+ * @param bytes Number of input bytes processed per round, 0 if not meaningful.
+ * @param fn The kernel, must do the same work on every call.
+ * @param arg Passed to fn.
+ * @return The median time of one round, in seconds.
+ */
+double bench_run(const char *name, size_t bytes, void (*fn)(void *arg), void *arg);
+
+/**
+ * Reports min, median and p99 of times the caller took itself, in the same
+ * format as bench_run(). For kernels that cannot be rerun as a whole, such
+ * as one append to a growing structure, with one sample per call.
+ *
+ * @param name Name of the measured kernel.
+ * @param bytes Number of input bytes processed per sample, 0 if not meaningful.
+ * @param samples The times in seconds, sorted in place.
+ * @param n Number of samples, at least 1.
+ * @return The median time, in seconds.
+ */
+double bench_report_samples(const char *name, size_t bytes, double *samples,
+			    size_t n);
+
+/**
+ * Prints a free-form remark (speedups, skipped kernels) to stdout, or to
+ * stderr with `BENCH_FORMAT=json` so that stdout stays machine-readable.
+ *
+ * @param fmt printf-style format, the line break is added.
+ */
+void bench_note(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * Scales a default input size by `BENCH_SCALE` (default 1), so a single
+ * setting resizes every generated input.
+ *
+ * @param n Default size.
+ * @return The scaled size, at least 1.
+ */
+size_t bench_scaled(size_t n);
+
+/**
+ * Returns the next value of a xorshift32 generator, good enough for synthetic inputs.
+ *
+ * @param state Generator state, must be non-zero.
+ * @return The next pseudo-random value.
+ */
+unsigned bench_rand(unsigned *state);
+
+/**
+ * Generates a synthetic day-1 input: `lines` rows of two 5-digit columns
+ * separated by three spaces.
+ *
+ * @param lines Number of rows to generate.
+ * @param seed Seed for the generator, same seed gives the same input.
+ * @param len Set to the length of the generated input.
+ * @return Heap buffer holding the input (null-terminated), to be freed by the caller.
+ */
+char *bench_gen_day1(size_t lines, unsigned seed, size_t *len);
+
+/**
+ * Generates a synthetic day-2 input: `reports` lines of 5 to 8 levels that
+ * mostly rise or fall by 1 to 3, with the occasional bad step so that safe,
+ * dampener-safe and unsafe reports all show up.
+ *
+ * @param reports Number of lines to generate.
+ * @param seed Seed for the generator, same seed gives the same input.
+ * @param len Set to the length of the generated input.
+ * @return Heap buffer holding the input (null-terminated), to be freed by the caller.
+ */
+char *bench_gen_day2(size_t reports, unsigned seed, size_t *len);
+
+/**
+ * Generates a synthetic day-3 input: printable random noise with a valid
+ * mul(a,b), do() or don't() inserted roughly every `spacing` bytes.
+ *
+ * @param bytes Approximate size of the input.
+ * @param spacing Average number of noise bytes between valid instructions.
+ * @param seed Seed for the generator, same seed gives the same input.
+ * @param len Set to the length of the generated input.
+ * @return Heap buffer holding the input (null-terminated), to be freed by the caller.
+ */
+char *bench_gen_day3(size_t bytes, size_t spacing, unsigned seed, size_t *len);
+
+#endif // BENCH_H
@@ -0,0 +1,95 @@
+#include "hcount.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/// Fibonacci hashing: spreads clustered keys (e.g. 5-digit ids) over the table
+static inline size_t hcount_slot(const hcount_t *h, int key)
+{
+	return (size_t)(((uint64_t)(uint32_t)key * 0x9e3779b97f4a7c15ULL) >> 32) &
+	       (h->cap - 1);
+}
+
+static void hcount_alloc(hcount_t *h, size_t cap)
+{
+	h->slots = calloc(cap, sizeof(hcount_entry_t));
+	if (!h->slots) {
+		fprintf(stderr, "ERROR: Failed to allocate count map\n");
+		exit(EXIT_FAILURE);
+	}
+	h->cap = cap;
+	h->size = 0;
+}
+
+void hcount_init(hcount_t *h, size_t expected)
+{
+	size_t cap = 16;
+
+	// Keep the load factor under 1/2 for the expected key count
+	while (cap < expected * 2)
+		cap *= 2;
+
+	hcount_alloc(h, cap);
+}
+
+void hcount_free(hcount_t *h)
+{
+	if (!h)
+		return;
+
+	free(h->slots);
+	h->slots = NULL;
+	h->cap = h->size = 0;
+}
+
+/// Find the slot holding key, or the empty slot where it would go
+static hcount_entry_t *hcount_find(const hcount_t *h, int key)
+{
+	size_t i = hcount_slot(h, key);
+
+	while (h->slots[i].used && h->slots[i].key != key)
+		i = (i + 1) & (h->cap - 1);
+
+	return &h->slots[i];
+}
+
+/// Double the table once it is 70% full
+static void hcount_grow_if_needed(hcount_t *h)
+{
+	if ((h->size + 1) * 10 < h->cap * 7)
+		return;
+
+	hcount_t old = *h;
+	hcount_alloc(h, old.cap * 2);
+
+	for (size_t i = 0; i < old.cap; i++) {
+		if (!old.slots[i].used)
+			continue;
+		*hcount_find(h, old.slots[i].key) = old.slots[i];
+		h->size++;
+	}
+
+	free(old.slots);
+}
+
+void hcount_add(hcount_t *h, int key, long long delta)
+{
+	hcount_entry_t *e = hcount_find(h, key);
+
+	if (!e->used) {
+		hcount_grow_if_needed(h);
+		e = hcount_find(h, key);
+		e->key = key;
+		e->used = 1;
+		e->count = 0;
+		h->size++;
+	}
+
+	e->count += delta;
+}
+
+long long hcount_get(const hcount_t *h, int key)
+{
+	const hcount_entry_t *e = hcount_find(h, key);
+	return e->used ? e->count : 0;
+}
@@ -0,0 +1,53 @@
+#ifndef HCOUNT_H
+#define HCOUNT_H
+
+#include <stddef.h> // For size_t
+
+/// One slot of the count map
+typedef struct {
+	int key; // Value being counted
+	int used; // Non-zero if the slot holds a key
+	long long count; // Number of occurrences of key
+} hcount_entry_t;
+
+/// Open-addressing (linear probing) map from int values to occurrence counts
+typedef struct {
+	hcount_entry_t *slots; // Slot array, cap entries
+	size_t cap; // Number of slots, always a power of two
+	size_t size; // Number of distinct keys
+} hcount_t;
+
+/**
+ * Initializes an empty count map.
+ *
+ * @param h Pointer to the map.
+ * @param expected Number of distinct keys expected, used to size the table up front.
+ */
+void hcount_init(hcount_t *h, size_t expected);
+
+/**
+ * Frees the memory associated with a count map.
+ *
+ * @param h Pointer to the map.
+ */
+void hcount_free(hcount_t *h);
+
+/**
+ * Adds delta to the count of key, inserting it with count 0 first if needed.
+ *
+ * @param h Pointer to the map.
+ * @param key Value to count.
+ * @param delta Amount to add, may be negative.
+ */
+void hcount_add(hcount_t *h, int key, long long delta);
+
+/**
+ * Returns the count of key.
+ *
+ * @param h Pointer to the map.
+ * @param key Value to look up.
+ * @return Count of key, 0 if it was never added.
+ */
+long long hcount_get(const hcount_t *h, int key);
+
+#endif // HCOUNT_H
@@ -1,3 +1,4 @@
+#include <errno.h>
 #include <stdio.h>
 #include <fcntl.h>
 #include <stdlib.h>
@@ -5,15 +6,62 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include "helpers.h"
+#include "stats.h"
 
-int read_file(const char *f_name, char **f_content)
+/// Slurp everything readable from fd into a heap buffer (pipes, stdin, ...)
+static int mfile_read_fd(int fd, mfile_t *mf)
+{
+	size_t cap = 1 << 16;
+	size_t len = 0;
+	char *buf = malloc(cap);
+
+	if (buf == NULL) {
+		perror("Failed to allocate memory");
+		return -1;
+	}
+
+	for (;;) {
+		if (len == cap) {
+			char *tmp = realloc(buf, cap * 2);
+			if (tmp == NULL) {
+				perror("Failed to allocate memory");
+				free(buf);
+				return -1;
+			}
+			buf = tmp;
+			cap *= 2;
+		}
+
+		ssize_t n = read(fd, buf + len, cap - len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("Failed to read file");
+			free(buf);
+			return -1;
+		}
+		if (n == 0)
+			break;
+		len += n;
+	}
+
+	mf->begin = buf;
+	mf->end = buf + len;
+	mf->len = len;
+	mf->mapped = 0;
+	return 0;
+}
+
+int mfile_open(const char *f_name, mfile_t *mf)
 {
 	int ret = 0;
-	int fd = open(f_name, O_RDONLY);
+	int use_stdin = (f_name == NULL || strcmp(f_name, "-") == 0);
+	int fd = use_stdin ? STDIN_FILENO : open(f_name, O_RDONLY);
 
 	if (fd < 0) {
 		perror("Failed to read file");
-		goto exit;
+		return -1;
 	}
 
 	struct stat sb;
@@ -23,65 +71,130 @@ int read_file(const char *f_name, char **f_content)
 		goto release_fd;
 	}
 
-	if (!sb.st_size) { // Handle empty file
-		*f_content = malloc(1); // Allocate a minimal buffer
-		if (*f_content == NULL) {
-			perror("Failed to allocate memory");
-			ret = -1;
-			goto exit;
-		}
-		(*f_content)[0] = '\0'; // Null-terminate
-		goto exit;
+	if (!S_ISREG(sb.st_mode)) { // Pipes, sockets, ttys: no size, no mmap
+		ret = mfile_read_fd(fd, mf);
+		goto release_fd;
 	}
 
-	// Allocate buffer to hold file content
-	*f_content = malloc(sb.st_size + 1); // +1 for null terminator
-	if (*f_content == NULL) {
-		perror("Failed to allocate memory");
-		ret = -1;
+	if (!sb.st_size) { // Handle empty file
+		mf->begin = mf->end = NULL;
+		mf->len = 0;
+		mf->mapped = 0;
 		goto release_fd;
 	}
 
-	char *mapped = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
-	if (f_content == MAP_FAILED) {
-		perror("Failed to map file");
-		ret = -1;
-		goto free_content;
+	int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+	flags |= MAP_POPULATE; // Prefault the whole file in one go
+#endif
+	char *mapped = mmap(NULL, sb.st_size, PROT_READ, flags, fd, 0);
+	if (mapped == MAP_FAILED) {
+		ret = mfile_read_fd(fd, mf);
+		goto release_fd;
 	}
 
-	memcpy(*f_content, mapped, sb.st_size);
-	/* (*f_content)[sb.st_size] = '\0'; */
+	// Only a hint, parsers walk the input front to back
+	madvise(mapped, sb.st_size, MADV_SEQUENTIAL);
 
-	munmap(mapped, sb.st_size);
-	goto release_fd;
+	mf->begin = mapped;
+	mf->end = mapped + sb.st_size;
+	mf->len = sb.st_size;
+	mf->mapped = 1;
 
-free_content:
-	free(*f_content);
 release_fd:
-	close(fd);
-exit:
+	if (!use_stdin)
+		close(fd);
+	if (ret == 0)
+		STATS_COUNT("bytes_read", mf->len);
 	return ret;
 }
 
-int count_str_lines(const char *str)
+void mfile_close(mfile_t *mf)
 {
-	int count = 0;
-	int is_empty_line = 1;
-
-	for (int i = 0; str[i] != '\0'; i++) {
-		if (str[i] == '\n') {
-			if (!is_empty_line)
-				count++;
-			is_empty_line = 1;
-		} else if (str[i] != ' ' && str[i] != '\t') {
-			is_empty_line = 0;
-		}
+	if (!mf)
+		return;
+
+	if (mf->mapped)
+		munmap((void *)mf->begin, mf->len);
+	else
+		free((void *)mf->begin);
+
+	mf->begin = mf->end = NULL;
+	mf->len = 0;
+	mf->mapped = 0;
+}
+
+int read_file(const char *f_name, char **f_content)
+{
+	mfile_t mf;
+
+	if (mfile_open(f_name, &mf) < 0)
+		return -1;
+
+	*f_content = malloc(mf.len + 1); // +1 for null terminator
+	if (*f_content == NULL) {
+		perror("Failed to allocate memory");
+		mfile_close(&mf);
+		return -1;
 	}
 
-	if (!is_empty_line)
-		count++;
+	if (mf.len)
+		memcpy(*f_content, mf.begin, mf.len);
+	(*f_content)[mf.len] = '\0';
+
+	mfile_close(&mf);
+	return 0;
+}
 
-	return count;
+/// One multiply-xorshift step of hash_bytes()
+static inline uint64_t hash_step(uint64_t h, uint64_t w)
+{
+	h = (h ^ w) * 0xff51afd7ed558ccdu;
+	return h ^ (h >> 32);
+}
+
+uint64_t hash_bytes(const void *data, size_t len)
+{
+	const unsigned char *p = data;
+	uint64_t h0 = 0x9e3779b97f4a7c15u ^ len, h1 = 0xc2b2ae3d27d4eb4fu;
+	uint64_t h2 = 0x165667b19e3779f9u, h3 = 0x27d4eb2f165667c5u;
+	uint64_t w0, w1, w2, w3;
+
+	// Four independent chains keep the multiplier busy. Plain scalars, not
+	// an array: SSE2 has no 64-bit multiply, so vectorizing them is slower
+	for (; len >= 32; p += 32, len -= 32) {
+		memcpy(&w0, p, 8);
+		memcpy(&w1, p + 8, 8);
+		memcpy(&w2, p + 16, 8);
+		memcpy(&w3, p + 24, 8);
+		h0 = hash_step(h0, w0);
+		h1 = hash_step(h1, w1);
+		h2 = hash_step(h2, w2);
+		h3 = hash_step(h3, w3);
+	}
+
+	uint64_t h = hash_step(hash_step(hash_step(h0, h1), h2), h3);
+
+	for (; len >= 8; p += 8, len -= 8) {
+		memcpy(&w0, p, 8);
+		h = hash_step(h, w0);
+	}
+
+	w0 = 0;
+	if (len)
+		memcpy(&w0, p, len);
+	h = hash_step(h, w0);
+
+	// Final avalanche, from MurmurHash3's fmix64
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53u;
+	h ^= h >> 33;
+	return h;
+}
+
+int count_str_lines(const char *str)
+{
+	return count_lines(str, str + strlen(str));
 }
 
 char *strsplit_r(char *s, const char *delim, char **save_ptr)
@@ -1,14 +1,65 @@
 #ifndef _HELPERS_H_
 #define _HELPERS_H_
 
+#include <stddef.h> // For size_t
+#include <stdint.h> // For uint64_t
+
+/// Read-only view of a whole input, either mmap'd or held in a heap buffer
+typedef struct {
+	const char *begin; // First byte of the content
+	const char *end; // One past the last byte of the content
+	size_t len; // Number of bytes in [begin, end)
+	int mapped; // Non-zero if the content is an mmap'd region
+} mfile_t;
+
+/**
+ * @brief Opens a file and exposes its contents as a read-only byte range without copying.
+ *
+ * Regular files are mapped with `mmap` (with `MAP_POPULATE` where available and
+ * `madvise(MADV_SEQUENTIAL)`), so `begin`/`end` point straight into the page cache. Inputs that
+ * cannot be mapped (pipes, sockets, ttys, stdin) fall back to buffered `read` calls into a heap
+ * buffer.
+ *
+ * @param f_name The name of the file to open, or `NULL` / `"-"` to read from stdin.
+ * @param mf     The handle to fill in.
+ *
+ * @return 0 on success, -1 on failure.
+ *
+ * @note
+ * - The range is **not** null-terminated and must not be written to; parsers have to stop at
+ *   `mf->end`.
+ * - An empty input yields `begin == end == NULL` and `len == 0`.
+ * - Release the handle with `mfile_close()`.
+ *
+ * @code{.c}
+ * mfile_t mf;
+ * if (mfile_open("data.input", &mf) == 0) {
+ *     for (const char *p = mf.begin; p < mf.end; p++)
+ *         ...;
+ *     mfile_close(&mf);
+ * }
+ * @endcode
+ */
+int mfile_open(const char *f_name, mfile_t *mf);
+
+/**
+ * @brief Releases a handle obtained from `mfile_open()`.
+ *
+ * Unmaps the region or frees the fallback buffer and resets the handle to an empty range.
+ *
+ * @param mf The handle to release. `NULL` is ignored.
+ */
+void mfile_close(mfile_t *mf);
+
 /**
  * @brief Reads the contents of a file into a dynamically allocated buffer.
  *
  * This function opens a file, determines its size, allocates a buffer to hold the entire file content 
  * (plus a null terminator), reads the file into the buffer using memory mapping for efficiency, 
- * and null-terminates the buffer.
+ * and null-terminates the buffer. It is a thin copying wrapper around `mfile_open()`; callers that
+ * only need read access should use that directly.
  *
- * @param f_name   The name of the file to read.
+ * @param f_name   The name of the file to read, or `NULL` / `"-"` for stdin.
  * @param f_content A pointer to a char pointer where the file content will be stored. The function
  *                  allocates memory for the content, and the caller is responsible for freeing
  *                  this memory using `free()`.
@@ -52,6 +103,19 @@
  */
 int read_file(const char *f_name, char **f_content);
 
+/**
+ * @brief Hashes a byte range into 64 bits, 32 bytes per step.
+ *
+ * Not cryptographic: meant to key caches by input content (see `rcache.h`), where a collision
+ * costs a wrong answer only together with an equal length.
+ *
+ * @param data First byte of the range.
+ * @param len  Number of bytes.
+ *
+ * @return The hash, stable for a given build and byte order.
+ */
+uint64_t hash_bytes(const void *data, size_t len);
+
 /**
  * @brief Counts the number of lines in a string.
  *
@@ -91,6 +155,107 @@ int read_file(const char *f_name, char **f_content);
  */
 int count_str_lines(const char *str);
 
+/**
+ * @brief Counts the number of lines in a byte range.
+ *
+ * Same rules as `count_str_lines()` (whitespace-only lines are not counted, a trailing line without
+ * a newline is), but bounded by `end` instead of a null terminator so it works on `mfile_t` ranges.
+ * This is `line_index()` without an index.
+ *
+ * @param begin First byte of the range.
+ * @param end   One past the last byte of the range.
+ *
+ * @return The number of non-empty lines in `[begin, end)`.
+ */
+int count_lines(const char *begin, const char *end);
+
+/// Line scanner implementations selectable with `line_index_use()`
+typedef enum {
+	LINES_AUTO, // Best one supported by the running CPU
+	LINES_SCALAR,
+	LINES_SSE2,
+	LINES_AVX2
+} lines_impl_t;
+
+/**
+ * @brief Counts the non-empty lines in a byte range and records where each one starts.
+ *
+ * The range is scanned 16 or 32 bytes at a time (SSE2/AVX2, picked at runtime) for newlines and
+ * non-blank bytes. Line rules are the same as `count_str_lines()`: lines holding only spaces and
+ * tabs are skipped, and a last line without a trailing newline is counted.
+ *
+ * The index works like `snprintf`: the return value is always the total number of lines, and at
+ * most `cap` offsets are written. Callers that know an upper bound (e.g. input length divided by
+ * the shortest possible line) get count and index in a single pass; otherwise call once with
+ * `offsets == NULL` to size the array.
+ *
+ * @param begin   First byte of the range.
+ * @param end     One past the last byte of the range.
+ * @param offsets Where to store the offset from `begin` of the first byte of each non-empty line,
+ *                or `NULL` to only count.
+ * @param cap     Number of slots in `offsets`.
+ *
+ * @return The number of non-empty lines in `[begin, end)`.
+ *
+ * @code{.c}
+ * size_t n = line_index(mf.begin, mf.end, NULL, 0);
+ * size_t *offs = malloc(n * sizeof(*offs));
+ * line_index(mf.begin, mf.end, offs, n);
+ * // Line i starts at mf.begin + offs[i] and runs up to the next '\n' or mf.end
+ * @endcode
+ */
+size_t line_index(const char *begin, const char *end, size_t *offsets, size_t cap);
+
+/**
+ * @brief Forces the implementation used by `line_index()` and `count_lines()`.
+ *
+ * Mostly for benchmarks and tests; by default the best supported one is picked on first use.
+ *
+ * @param impl The implementation to use.
+ *
+ * @return 0 on success, -1 if the running CPU does not support it.
+ */
+int line_index_use(lines_impl_t impl);
+
+/**
+ * @brief Parses an unsigned decimal integer from a byte range.
+ *
+ * Leading spaces and tabs are skipped, then the longest run of digits is converted. Unlike `atoi`
+ * or `strtol` the input does not need to be null-terminated or writable, no locale is consulted and
+ * the cursor past the number is returned, so a line can be consumed number by number. Digit runs
+ * are converted 8 bytes at a time with SWAR arithmetic when at least 8 bytes remain, which covers
+ * fixed-width columns like day-1's 5-digit values in a single step.
+ *
+ * @param p   Where to start scanning.
+ * @param end One past the last byte that may be read.
+ * @param out Set to the parsed value. Overflow wraps, as with `atoi`.
+ *
+ * @return The cursor just past the last digit, or `NULL` if no digit was found (`*out` is then
+ *         left untouched).
+ *
+ * @code{.c}
+ * const char *line = "3   4\n";
+ * const char *end = line + 6;
+ * unsigned a, b;
+ * const char *p = scan_uint(line, end, &a); // a == 3, p points at the spaces
+ * p = scan_uint(p, end, &b); // b == 4, p points at '\n'
+ * @endcode
+ */
+const char *scan_uint(const char *p, const char *end, unsigned *out);
+
+/**
+ * @brief Parses a signed decimal integer from a byte range.
+ *
+ * Same as `scan_uint()`, with an optional `-` or `+` sign directly in front of the digits.
+ *
+ * @param p   Where to start scanning.
+ * @param end One past the last byte that may be read.
+ * @param out Set to the parsed value.
+ *
+ * @return The cursor just past the last digit, or `NULL` if no number was found.
+ */
+const char *scan_int(const char *p, const char *end, int *out);
+
 /**
  *
  * @brief A reentrant string tokenizer that supports multi-character delimiters.
@@ -0,0 +1,135 @@
+#include "helpers.h"
+#include "vec.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/// Inputs shared by every kernel
+typedef struct {
+	const char *path; // Generated input written to disk, for read_file
+	char *text; // Same input in memory, null-terminated
+	size_t len;
+	char *work; // Scratch copy for strsplit_r, which writes to its input
+	vec_t *ints; // Level values parsed from text
+	long long sink; // Keeps results alive
+} kernel_input_t;
+
+static void run_read_file(void *arg)
+{
+	kernel_input_t *in = arg;
+	char *content;
+
+	if (read_file(in->path, &content) < 0)
+		exit(EXIT_FAILURE);
+	in->sink += content[0];
+	free(content);
+}
+
+/// The cost a cache lookup adds on top of loading the input
+static void run_hash_bytes(void *arg)
+{
+	kernel_input_t *in = arg;
+	in->sink += hash_bytes(in->text, in->len) & 1;
+}
+
+static void run_count_str_lines(void *arg)
+{
+	kernel_input_t *in = arg;
+	in->sink += count_str_lines(in->text);
+}
+
+/// Includes restoring the input, strsplit_r consumes it
+static void run_strsplit_r(void *arg)
+{
+	kernel_input_t *in = arg;
+	char *save;
+	long long tokens = 0;
+
+	memcpy(in->work, in->text, in->len + 1);
+	for (char *tok = strsplit_r(in->work, "\n", &save); tok;
+	     tok = strsplit_r(NULL, "\n", &save))
+		tokens++;
+	in->sink += tokens;
+}
+
+static void run_vec_push(void *arg)
+{
+	kernel_input_t *in = arg;
+	vec_t *v = vec_create(TYPE_INT);
+
+	for (size_t i = 0; i < vec_size(in->ints); i++)
+		vec_push_back(v, vec_at(in->ints, i));
+	in->sink += vec_size(v);
+	vec_destroy(v);
+}
+
+static void run_vec_at(void *arg)
+{
+	kernel_input_t *in = arg;
+	long long sum = 0;
+
+	for (size_t i = 0; i < vec_size(in->ints); i++)
+		sum += *(int *)vec_at(in->ints, i);
+	in->sink += sum;
+}
+
+static void run_vec_copy(void *arg)
+{
+	kernel_input_t *in = arg;
+	vec_t *copy = vec_copy(in->ints);
+
+	in->sink += vec_size(copy);
+	vec_destroy(copy);
+}
+
+int main(int argc, char **argv)
+{
+	size_t reports = argc > 1 ? strtoul(argv[1], NULL, 10) :
+				    bench_scaled(2000000);
+	char path[] = "/tmp/helpers_bench.XXXXXX";
+	kernel_input_t in = { .path = path };
+
+	in.text = bench_gen_day2(reports, 42, &in.len);
+	in.work = malloc(in.len + 1);
+	in.ints = vec_create(TYPE_INT);
+	if (!in.work) {
+		fprintf(stderr, "ERROR: Failed to allocate scratch input\n");
+		return 1;
+	}
+
+	int fd = mkstemp(path);
+	if (fd < 0 || write(fd, in.text, in.len) != (ssize_t)in.len) {
+		perror("Failed to write benchmark input");
+		return 1;
+	}
+	close(fd);
+
+	const char *p = in.text, *end = in.text + in.len;
+	int num;
+	while (p < end) {
+		const char *next = scan_int(p, end, &num);
+		if (next) {
+			vec_push_back(in.ints, &num);
+			p = next;
+		} else {
+			p++;
+		}
+	}
+
+	size_t int_bytes = vec_size(in.ints) * sizeof(int);
+	bench_run("helpers/read_file", in.len, run_read_file, &in);
+	bench_run("helpers/hash_bytes", in.len, run_hash_bytes, &in);
+	bench_run("helpers/count_str_lines", in.len, run_count_str_lines, &in);
+	bench_run("helpers/strsplit_r", in.len, run_strsplit_r, &in);
+	bench_run("helpers/vec_push_back", int_bytes, run_vec_push, &in);
+	bench_run("helpers/vec_at", int_bytes, run_vec_at, &in);
+	bench_run("helpers/vec_copy", int_bytes, run_vec_copy, &in);
+
+	unlink(path);
+	vec_destroy(in.ints);
+	free(in.work);
+	free(in.text);
+	return in.sink == 0; // Never true, stops the work being optimized out
+}
@@ -0,0 +1,55 @@
+#include "jagged.h"
+#include "helpers.h"
+#include <string.h>
+
+void jagged_init(jagged_t *j)
+{
+	memset(j, 0, sizeof(*j));
+	offvec_push(&j->offsets, 0);
+}
+
+void jagged_free(jagged_t *j)
+{
+	if (!j)
+		return;
+
+	ivec_free(&j->values);
+	offvec_free(&j->offsets);
+}
+
+void jagged_clear(jagged_t *j)
+{
+	ivec_clear(&j->values);
+	offvec_clear(&j->offsets);
+	offvec_push(&j->offsets, 0);
+}
+
+size_t jagged_parse_ints(jagged_t *j, const char *begin, const char *end)
+{
+	size_t rows = jagged_rows(j);
+	const char *line = begin;
+	int num;
+
+	// Every value takes a digit and a separator: reserving for the worst
+	// case keeps the pushes below free of reallocation
+	ivec_reserve(&j->values,
+		     ivec_size(&j->values) + (end - begin) / 2 + 1);
+
+	while (line < end) {
+		const char *eol = memchr(line, '\n', end - line);
+		if (!eol)
+			eol = end;
+
+		size_t before = ivec_size(&j->values);
+		const char *p = line;
+		while ((p = scan_int(p, eol, &num)) != NULL)
+			jagged_push(j, num);
+
+		if (ivec_size(&j->values) != before)
+			jagged_end_row(j);
+
+		line = eol + 1;
+	}
+
+	return jagged_rows(j) - rows;
+}
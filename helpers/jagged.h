@@ -0,0 +1,103 @@
+#ifndef JAGGED_H
+#define JAGGED_H
+
+#include <assert.h>
+#include <stddef.h> // For size_t
+#include "tvec.h"
+
+TVEC_DEFINE(offvec, size_t)
+
+/// Rows of ints of varying length, stored back to back (CSR layout)
+typedef struct {
+	ivec_t values; // Every value, row after row
+	offvec_t offsets; // Row r is values[offsets[r], offsets[r + 1]), always starts with 0
+} jagged_t;
+
+/// Read-only view of one row
+typedef struct {
+	const int *values; // First value of the row
+	size_t len; // Number of values
+} jagged_row_t;
+
+/**
+ * Initializes an empty container.
+ *
+ * @param j Pointer to the container.
+ */
+void jagged_init(jagged_t *j);
+
+/**
+ * Frees the memory associated with a container.
+ *
+ * @param j Pointer to the container.
+ */
+void jagged_free(jagged_t *j);
+
+/**
+ * Removes all rows, keeping the allocated capacity.
+ *
+ * @param j Pointer to the container.
+ */
+void jagged_clear(jagged_t *j);
+
+/**
+ * Appends one value to the row being built.
+ *
+ * @param j Pointer to the container.
+ * @param value The value to append.
+ */
+static inline void jagged_push(jagged_t *j, int value)
+{
+	ivec_push(&j->values, value);
+}
+
+/**
+ * Closes the row being built. Values pushed afterwards start a new row.
+ *
+ * @param j Pointer to the container.
+ */
+static inline void jagged_end_row(jagged_t *j)
+{
+	offvec_push(&j->offsets, ivec_size(&j->values));
+}
+
+/**
+ * Returns the number of closed rows.
+ *
+ * @param j Pointer to the container.
+ * @return Number of rows.
+ */
+static inline size_t jagged_rows(const jagged_t *j)
+{
+	return offvec_size(&j->offsets) - 1;
+}
+
+/**
+ * Returns a view of one row. It stays valid until the container grows.
+ *
+ * @param j Pointer to the container.
+ * @param r Index of the row.
+ * @return The row.
+ */
+static inline jagged_row_t jagged_row(const jagged_t *j, size_t r)
+{
+	assert(r < jagged_rows(j) && "Row out of bounds");
+
+	const size_t *off = j->offsets.data;
+	jagged_row_t row = { j->values.data + off[r], off[r + 1] - off[r] };
+	return row;
+}
+
+/**
+ * Appends one row per non-blank line of whitespace separated integers in
+ * [begin, end), in a single pass. Blank lines add no row, and a line stops
+ * at the first token that is not an integer.
+ *
+ * @param j Pointer to the container.
+ * @param begin First byte of the text.
+ * @param end One past the last byte of the text.
+ * @return Number of rows added.
+ */
+size_t jagged_parse_ints(jagged_t *j, const char *begin, const char *end);
+
+#endif // JAGGED_H
@@ -0,0 +1,73 @@
+#include "jagged.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+void test_build_rows(void)
+{
+	jagged_t j;
+	jagged_init(&j);
+	assert(jagged_rows(&j) == 0);
+
+	for (int r = 0; r < 100; r++) {
+		for (int i = 0; i < r % 7; i++)
+			jagged_push(&j, r * 10 + i);
+		jagged_end_row(&j);
+	}
+
+	assert(jagged_rows(&j) == 100);
+	for (size_t r = 0; r < 100; r++) {
+		jagged_row_t row = jagged_row(&j, r);
+		assert(row.len == r % 7);
+		for (size_t i = 0; i < row.len; i++)
+			assert(row.values[i] == (int)(r * 10 + i));
+	}
+
+	// Rows are back to back in one array
+	jagged_row_t a = jagged_row(&j, 1), b = jagged_row(&j, 2);
+	assert(a.values + a.len == b.values);
+
+	jagged_clear(&j);
+	assert(jagged_rows(&j) == 0);
+	jagged_free(&j);
+	printf("test_build_rows passed.\n");
+}
+
+void test_parse_ints(void)
+{
+	static const char text[] = "7 6 4 2 1\n\n  -3\t12 +5\n1 2 x 3\n42";
+	jagged_t j;
+
+	jagged_init(&j);
+	assert(jagged_parse_ints(&j, text, text + strlen(text)) == 4);
+
+	jagged_row_t row = jagged_row(&j, 0);
+	assert(row.len == 5 && row.values[0] == 7 && row.values[4] == 1);
+
+	row = jagged_row(&j, 1); // The blank line adds no row
+	assert(row.len == 3 && row.values[0] == -3 && row.values[1] == 12 &&
+	       row.values[2] == 5);
+
+	row = jagged_row(&j, 2); // Stops at the first non-integer
+	assert(row.len == 2 && row.values[1] == 2);
+
+	row = jagged_row(&j, 3); // No trailing newline
+	assert(row.len == 1 && row.values[0] == 42);
+
+	// Parsing appends to what is already there
+	assert(jagged_parse_ints(&j, text, text + 9) == 1);
+	assert(jagged_rows(&j) == 5 && jagged_row(&j, 4).len == 5);
+
+	assert(jagged_parse_ints(&j, text, text) == 0);
+	jagged_free(&j);
+	printf("test_parse_ints passed.\n");
+}
+
+int main(void)
+{
+	test_build_rows();
+	test_parse_ints();
+
+	printf("All tests passed.\n");
+	return 0;
+}
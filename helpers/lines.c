@@ -0,0 +1,177 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "helpers.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LINES_X86 1
+#endif
+
+/// Running state of a line scan, carried from one block to the next
+typedef struct {
+	const char *begin; // Start of the scanned range, offsets are relative to it
+	const char *line_start; // First byte of the line being scanned
+	int has_content; // Seen a non-blank byte since line_start
+	size_t count; // Non-empty lines found so far
+	size_t *offsets; // Optional output index
+	size_t cap; // Number of slots in offsets
+} line_scan_t;
+
+static inline void line_scan_emit(line_scan_t *st)
+{
+	if (st->count < st->cap)
+		st->offsets[st->count] = st->line_start - st->begin;
+	st->count++;
+}
+
+/// Consume one block of up to 32 bytes at p, given its newline and content bitmasks.
+/// A line counts if any content bit falls between the previous newline and its newline.
+static inline void line_scan_block(line_scan_t *st, const char *p, uint32_t nl,
+				   uint32_t content)
+{
+	while (nl) {
+		int i = __builtin_ctz(nl);
+
+		if (st->has_content || (content & ((1u << i) - 1)))
+			line_scan_emit(st);
+
+		st->has_content = 0;
+		st->line_start = p + i + 1;
+		content &= ~((2u << i) - 1); // Drop bits up to and including this newline
+		nl &= nl - 1;
+	}
+
+	st->has_content |= (content != 0);
+}
+
+static void line_scan_scalar(line_scan_t *st, const char *p, const char *end)
+{
+	for (; p < end; p++) {
+		if (*p == '\n') {
+			if (st->has_content)
+				line_scan_emit(st);
+			st->has_content = 0;
+			st->line_start = p + 1;
+		} else if (*p != ' ' && *p != '\t') {
+			st->has_content = 1;
+		}
+	}
+}
+
+#ifdef LINES_X86
+__attribute__((target("sse2"))) static void
+line_scan_sse2(line_scan_t *st, const char *p, const char *end)
+{
+	const __m128i nl_c = _mm_set1_epi8('\n');
+	const __m128i sp_c = _mm_set1_epi8(' ');
+	const __m128i tab_c = _mm_set1_epi8('\t');
+
+	for (; end - p >= 16; p += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+		uint32_t nl = _mm_movemask_epi8(_mm_cmpeq_epi8(v, nl_c));
+		uint32_t blank = _mm_movemask_epi8(_mm_or_si128(
+			_mm_cmpeq_epi8(v, sp_c), _mm_cmpeq_epi8(v, tab_c)));
+
+		line_scan_block(st, p, nl, ~(nl | blank) & 0xffff);
+	}
+
+	line_scan_scalar(st, p, end);
+}
+
+__attribute__((target("avx2"))) static void
+line_scan_avx2(line_scan_t *st, const char *p, const char *end)
+{
+	const __m256i nl_c = _mm256_set1_epi8('\n');
+	const __m256i sp_c = _mm256_set1_epi8(' ');
+	const __m256i tab_c = _mm256_set1_epi8('\t');
+
+	for (; end - p >= 32; p += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)p);
+		uint32_t nl = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl_c));
+		uint32_t blank = _mm256_movemask_epi8(_mm256_or_si256(
+			_mm256_cmpeq_epi8(v, sp_c), _mm256_cmpeq_epi8(v, tab_c)));
+
+		line_scan_block(st, p, nl, ~(nl | blank));
+	}
+
+	line_scan_scalar(st, p, end);
+}
+#endif
+
+typedef void (*line_scan_fn)(line_scan_t *, const char *, const char *);
+
+/// NULL until the first line_index_use(); read by every thread that indexes
+/// lines, so it is only ever stored and loaded atomically
+static line_scan_fn line_scan_impl;
+
+int line_index_use(lines_impl_t impl)
+{
+	line_scan_fn scan;
+
+	switch (impl) {
+	case LINES_AUTO:
+#ifdef LINES_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return line_index_use(LINES_AVX2);
+		if (__builtin_cpu_supports("sse2"))
+			return line_index_use(LINES_SSE2);
+#endif
+		return line_index_use(LINES_SCALAR);
+	case LINES_SCALAR:
+		scan = line_scan_scalar;
+		break;
+#ifdef LINES_X86
+	case LINES_SSE2:
+		__builtin_cpu_init();
+		if (!__builtin_cpu_supports("sse2"))
+			return -1;
+		scan = line_scan_sse2;
+		break;
+	case LINES_AVX2:
+		__builtin_cpu_init();
+		if (!__builtin_cpu_supports("avx2"))
+			return -1;
+		scan = line_scan_avx2;
+		break;
+#endif
+	default:
+		return -1;
+	}
+
+	__atomic_store_n(&line_scan_impl, scan, __ATOMIC_RELEASE);
+	return 0;
+}
+
+size_t line_index(const char *begin, const char *end, size_t *offsets,
+		  size_t cap)
+{
+	line_scan_t st = {
+		.begin = begin,
+		.line_start = begin,
+		.has_content = 0,
+		.count = 0,
+		.offsets = offsets,
+		.cap = offsets ? cap : 0,
+	};
+
+	// Threads racing through the first use all store the same scanner
+	line_scan_fn scan = __atomic_load_n(&line_scan_impl, __ATOMIC_ACQUIRE);
+	if (!scan) {
+		line_index_use(LINES_AUTO);
+		scan = __atomic_load_n(&line_scan_impl, __ATOMIC_ACQUIRE);
+	}
+
+	if (begin < end)
+		scan(&st, begin, end);
+
+	if (st.has_content) // Last line without a trailing newline
+		line_scan_emit(&st);
+
+	return st.count;
+}
+
+int count_lines(const char *begin, const char *end)
+{
+	return (int)line_index(begin, end, NULL, 0);
+}
@@ -0,0 +1,77 @@
+#include "helpers.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const struct {
+	lines_impl_t impl;
+	const char *name;
+} impls[] = {
+	{ LINES_SCALAR, "scalar" },
+	{ LINES_SSE2, "sse2" },
+	{ LINES_AVX2, "avx2" },
+};
+
+/// Input shared by both kernels, and what they found
+typedef struct {
+	const char *input;
+	size_t len;
+	size_t *offsets; // NULL: count only
+	size_t cap;
+	size_t got;
+} lines_job_t;
+
+static void run_line_index(void *arg)
+{
+	lines_job_t *job = arg;
+
+	job->got = line_index(job->input, job->input + job->len, job->offsets,
+			      job->cap);
+}
+
+int main(int argc, char **argv)
+{
+	size_t lines = argc > 1 ? strtoul(argv[1], NULL, 10) :
+				  bench_scaled(10000000);
+	size_t len;
+	char *input = bench_gen_day1(lines, 42, &len);
+	size_t *offsets = malloc(lines * sizeof(*offsets));
+	size_t *expected = malloc(lines * sizeof(*offsets));
+
+	// Reference results from the byte-at-a-time scanner
+	line_index_use(LINES_SCALAR);
+	size_t want = line_index(input, input + len, expected, lines);
+	if (want != lines || count_str_lines(input) != (int)lines) {
+		fprintf(stderr, "ERROR: scalar line count mismatch\n");
+		return 1;
+	}
+
+	for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+		lines_job_t count = { input, len, NULL, 0, 0 };
+		lines_job_t index = { input, len, offsets, lines, 0 };
+		char name[64];
+
+		if (line_index_use(impls[i].impl) < 0) {
+			bench_note("%-28s unsupported", impls[i].name);
+			continue;
+		}
+
+		snprintf(name, sizeof(name), "count_lines/%s", impls[i].name);
+		bench_run(name, len, run_line_index, &count);
+		snprintf(name, sizeof(name), "line_index/%s", impls[i].name);
+		bench_run(name, len, run_line_index, &index);
+
+		if (count.got != want || index.got != want ||
+		    memcmp(offsets, expected, want * sizeof(*offsets))) {
+			fprintf(stderr, "ERROR: %s disagrees with scalar\n",
+				impls[i].name);
+			return 1;
+		}
+	}
+
+	free(offsets);
+	free(expected);
+	free(input);
+	return 0;
+}
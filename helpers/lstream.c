@@ -0,0 +1,243 @@
+#include "lstream.h"
+#include "stats.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/// Background thread: fill buffers 0, 1, 0, ... as soon as the consumer hands them back
+static void *lstream_reader(void *arg)
+{
+	lstream_t *ls = arg;
+	int slot = 0;
+
+	// Only a blocking read() may be cancelled, never while holding the lock
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+	for (;;) {
+		pthread_mutex_lock(&ls->lock);
+		while (ls->full[slot] && !ls->stop)
+			pthread_cond_wait(&ls->cond, &ls->lock);
+		int stop = ls->stop;
+		pthread_mutex_unlock(&ls->lock);
+
+		if (stop)
+			break;
+
+		// Keep reading until the chunk is full so pipes don't produce tiny chunks
+		size_t n = 0;
+		int err = 0;
+		while (n < ls->chunk_size) {
+			pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+			ssize_t r = read(ls->fd, ls->buf[slot] + n,
+					 ls->chunk_size - n);
+			pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+			if (r < 0) {
+				if (errno == EINTR)
+					continue;
+				err = errno;
+				break;
+			}
+			if (r == 0)
+				break;
+			n += r;
+		}
+
+		STATS_COUNT("bytes_read", n);
+
+		pthread_mutex_lock(&ls->lock);
+		ls->fill[slot] = n;
+		if (n)
+			ls->full[slot] = 1;
+		if (n < ls->chunk_size) {
+			ls->error = err;
+			ls->eof = 1;
+		}
+		pthread_cond_broadcast(&ls->cond);
+		pthread_mutex_unlock(&ls->lock);
+
+		if (n < ls->chunk_size)
+			break;
+
+		slot ^= 1;
+	}
+
+	return NULL;
+}
+
+int lstream_open(const char *f_name, size_t chunk_size, char delim, lstream_t *ls)
+{
+	memset(ls, 0, sizeof(*ls));
+	ls->cur = -1;
+	ls->delim = delim;
+	ls->chunk_size = chunk_size ? chunk_size : LSTREAM_DEFAULT_CHUNK;
+
+	if (f_name == NULL || strcmp(f_name, "-") == 0) {
+		ls->fd = STDIN_FILENO;
+	} else {
+		ls->fd = open(f_name, O_RDONLY);
+		if (ls->fd < 0) {
+			perror("Failed to read file");
+			return -1;
+		}
+		ls->close_fd = 1;
+#ifdef POSIX_FADV_SEQUENTIAL
+		posix_fadvise(ls->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+	}
+
+	ls->buf[0] = malloc(ls->chunk_size);
+	ls->buf[1] = malloc(ls->chunk_size);
+	if (!ls->buf[0] || !ls->buf[1]) {
+		perror("Failed to allocate memory");
+		goto free_bufs;
+	}
+
+	pthread_mutex_init(&ls->lock, NULL);
+	pthread_cond_init(&ls->cond, NULL);
+
+	if (pthread_create(&ls->reader, NULL, lstream_reader, ls) != 0) {
+		fprintf(stderr, "ERROR: Failed to start reader thread\n");
+		pthread_cond_destroy(&ls->cond);
+		pthread_mutex_destroy(&ls->lock);
+		goto free_bufs;
+	}
+
+	return 0;
+
+free_bufs:
+	free(ls->buf[0]);
+	free(ls->buf[1]);
+	if (ls->close_fd)
+		close(ls->fd);
+	return -1;
+}
+
+/// Hand the current buffer back to the reader and wait for the next one.
+/// Returns 1 if a new chunk is available, 0 at end of input, -1 on error.
+static int lstream_fill(lstream_t *ls)
+{
+	int next = ls->cur < 0 ? 0 : ls->cur ^ 1;
+
+	pthread_mutex_lock(&ls->lock);
+	if (ls->cur >= 0) {
+		ls->full[ls->cur] = 0;
+		pthread_cond_broadcast(&ls->cond);
+	}
+
+	while (!ls->full[next] && !ls->eof)
+		pthread_cond_wait(&ls->cond, &ls->lock);
+
+	int have = ls->full[next];
+	int error = ls->error;
+	pthread_mutex_unlock(&ls->lock);
+
+	if (!have) {
+		ls->pos = ls->end = NULL;
+		if (error) {
+			errno = error;
+			perror("Failed to read file");
+			return -1;
+		}
+		return 0;
+	}
+
+	ls->cur = next;
+	ls->pos = ls->buf[next];
+	ls->end = ls->pos + ls->fill[next];
+	return 1;
+}
+
+/// Append bytes to the carry buffer holding a record split across chunks
+static int lstream_carry(lstream_t *ls, const char *p, size_t n)
+{
+	if (ls->carry_len + n > ls->carry_cap) {
+		size_t new_cap = ls->carry_cap ? ls->carry_cap : 256;
+		while (new_cap < ls->carry_len + n)
+			new_cap *= 2;
+
+		char *tmp = realloc(ls->carry, new_cap);
+		if (!tmp) {
+			perror("Failed to allocate memory");
+			return -1;
+		}
+		ls->carry = tmp;
+		ls->carry_cap = new_cap;
+	}
+
+	memcpy(ls->carry + ls->carry_len, p, n);
+	ls->carry_len += n;
+	return 0;
+}
+
+int lstream_next(lstream_t *ls, const char **rec, size_t *len)
+{
+	ls->carry_len = 0;
+
+	for (;;) {
+		if (ls->pos < ls->end) {
+			const char *eor =
+				memchr(ls->pos, ls->delim, ls->end - ls->pos);
+
+			if (eor && !ls->carry_len) { // Common case: no copy
+				*rec = ls->pos;
+				*len = eor - ls->pos;
+				ls->pos = eor + 1;
+				return 1;
+			}
+
+			const char *stop = eor ? eor : ls->end;
+			if (lstream_carry(ls, ls->pos, stop - ls->pos) < 0)
+				return -1;
+			ls->pos = eor ? eor + 1 : ls->end;
+
+			if (eor) {
+				*rec = ls->carry;
+				*len = ls->carry_len;
+				return 1;
+			}
+		}
+
+		int ret = lstream_fill(ls);
+		if (ret < 0)
+			return -1;
+
+		if (ret == 0) {
+			if (!ls->carry_len)
+				return 0;
+
+			// Last record without a trailing terminator
+			*rec = ls->carry;
+			*len = ls->carry_len;
+			return 1;
+		}
+	}
+}
+
+void lstream_close(lstream_t *ls)
+{
+	if (!ls)
+		return;
+
+	pthread_mutex_lock(&ls->lock);
+	ls->stop = 1;
+	pthread_cond_broadcast(&ls->cond);
+	pthread_mutex_unlock(&ls->lock);
+
+	// Closing before end of input may leave the reader blocked on a pipe
+	pthread_cancel(ls->reader);
+	pthread_join(ls->reader, NULL);
+	pthread_cond_destroy(&ls->cond);
+	pthread_mutex_destroy(&ls->lock);
+
+	free(ls->buf[0]);
+	free(ls->buf[1]);
+	free(ls->carry);
+
+	if (ls->close_fd)
+		close(ls->fd);
+
+	memset(ls, 0, sizeof(*ls));
+}
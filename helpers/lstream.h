@@ -0,0 +1,86 @@
+#ifndef LSTREAM_H
+#define LSTREAM_H
+
+#include <stddef.h> // For size_t
+#include <pthread.h>
+
+/// Default size of each of the two chunk buffers
+#define LSTREAM_DEFAULT_CHUNK (1 << 20)
+
+/// Streaming record reader over a file descriptor with double-buffered chunks
+typedef struct {
+	int fd; // Descriptor being read
+	int close_fd; // Non-zero if lstream_close() should close fd
+	char delim; // Record terminator
+	size_t chunk_size; // Size of each chunk buffer
+
+	char *buf[2]; // Chunk buffers, filled alternately by the reader thread
+	size_t fill[2]; // Number of valid bytes in each buffer
+	int full[2]; // Non-zero while a buffer is owned by the consumer
+	int eof; // Reader thread is done (end of input or error)
+	int error; // errno of a failed read, 0 otherwise
+	int stop; // Asks the reader thread to exit early
+
+	int cur; // Buffer being consumed, -1 before the first chunk
+	const char *pos; // Next unconsumed byte in the current buffer
+	const char *end; // End of the current buffer
+
+	char *carry; // Record split across chunk boundaries
+	size_t carry_len;
+	size_t carry_cap;
+
+	pthread_t reader;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+} lstream_t;
+
+/**
+ * @brief Opens a streaming record reader on a file, pipe or stdin.
+ *
+ * Input is read in fixed-size chunks by a background thread into two alternating buffers, so the
+ * next chunk is being read while the caller parses the current one. Memory use is bounded by two
+ * chunks plus the longest record that straddles a chunk boundary.
+ *
+ * @param f_name     The name of the file to read, or `NULL` / `"-"` for stdin.
+ * @param chunk_size Size of each chunk buffer, 0 for `LSTREAM_DEFAULT_CHUNK`.
+ * @param delim      Record terminator, usually `'\n'`.
+ * @param ls         The reader to initialize.
+ *
+ * @return 0 on success, -1 on failure.
+ *
+ * @code{.c}
+ * lstream_t ls;
+ * const char *rec;
+ * size_t len;
+ *
+ * if (lstream_open("data.input", 0, '\n', &ls) == 0) {
+ *     while (lstream_next(&ls, &rec, &len) > 0)
+ *         printf("%.*s\n", (int)len, rec);
+ *     lstream_close(&ls);
+ * }
+ * @endcode
+ */
+int lstream_open(const char *f_name, size_t chunk_size, char delim, lstream_t *ls);
+
+/**
+ * @brief Returns the next record, without its terminator.
+ *
+ * Records that cross a chunk boundary are reassembled, and a final record without a trailing
+ * terminator is still returned. Empty records are returned as zero-length records.
+ *
+ * @param ls  The reader.
+ * @param rec Set to the first byte of the record. Not null-terminated; valid until the next call.
+ * @param len Set to the record length in bytes.
+ *
+ * @return 1 if a record was returned, 0 at end of input, -1 on read error.
+ */
+int lstream_next(lstream_t *ls, const char **rec, size_t *len);
+
+/**
+ * @brief Stops the reader thread and releases all buffers.
+ *
+ * @param ls The reader to close.
+ */
+void lstream_close(lstream_t *ls);
+
+#endif // LSTREAM_H
@@ -0,0 +1,210 @@
+#include "rcache.h"
+#include "helpers.h"
+#include "stats.h"
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int rcache_open(rcache_t *c, const char *dir)
+{
+	memset(c, 0, sizeof(*c));
+
+	if (!dir)
+		dir = getenv("RCACHE_DIR");
+	if (!dir || !*dir)
+		dir = RCACHE_DEFAULT_DIR;
+
+	if (mkdir(dir, 0777) < 0 && errno != EEXIST) {
+		perror("Failed to create cache directory");
+		return -1;
+	}
+
+	c->dir = strdup(dir);
+	if (!c->dir) {
+		fprintf(stderr, "ERROR: Failed to allocate memory\n");
+		exit(EXIT_FAILURE);
+	}
+	return 0;
+}
+
+int rcache_parse_arg(const char *arg, rcache_opts_t *opts)
+{
+	if (strcmp(arg, "--cache") == 0) {
+		opts->use = 1;
+	} else if (strncmp(arg, "--cache=", 8) == 0) {
+		opts->use = 1;
+		opts->dir = arg + 8;
+	} else if (strcmp(arg, "--cache-clear") == 0) {
+		opts->use = opts->clear = 1;
+	} else {
+		return 0;
+	}
+	return 1;
+}
+
+int rcache_open_solver(rcache_t *c, const rcache_opts_t *opts,
+		       const char *solver, int stream)
+{
+	memset(c, 0, sizeof(*c));
+	if (!opts->use)
+		return 0;
+
+	if (rcache_open(c, opts->dir) < 0)
+		return -1;
+	if (opts->clear)
+		rcache_clear(c, solver);
+
+	if (stream) {
+		rcache_close(c);
+		return 0;
+	}
+	return 1;
+}
+
+void rcache_close(rcache_t *c)
+{
+	if (!c)
+		return;
+
+	free(c->dir);
+	c->dir = NULL;
+}
+
+rcache_key_t rcache_key(const char *solver, const char *begin, const char *end)
+{
+	size_t len = end - begin;
+	rcache_key_t key = { solver, hash_bytes(begin, len), len };
+	return key;
+}
+
+/// Entry file name: <dir>/<solver>-<hash>
+static void rcache_path(const rcache_t *c, const rcache_key_t *key, char *path,
+			size_t size)
+{
+	snprintf(path, size, "%s/%s-%016llx", c->dir, key->solver,
+		 (unsigned long long)key->hash);
+}
+
+int rcache_get(rcache_t *c, const rcache_key_t *key, long long *answers, int n)
+{
+	char path[4096];
+	unsigned long long len;
+	long long found[RCACHE_MAX_ANSWERS];
+	int stored;
+	int hit = 0;
+
+	rcache_path(c, key, path, sizeof(path));
+
+	// Entry format: "<input length> <n> <answer>...\n"
+	FILE *f = fopen(path, "r");
+	if (f) {
+		if (fscanf(f, "%llu %d", &len, &stored) == 2 &&
+		    len == key->len && stored == n && n <= RCACHE_MAX_ANSWERS) {
+			hit = 1;
+			for (int i = 0; i < n && hit; i++)
+				hit = fscanf(f, "%lld", &found[i]) == 1;
+		}
+		fclose(f);
+	}
+
+	if (hit) {
+		memcpy(answers, found, sizeof(*answers) * n);
+		__atomic_fetch_add(&c->hits, 1, __ATOMIC_RELAXED);
+		STATS_COUNT("cache_hits", 1);
+	} else {
+		__atomic_fetch_add(&c->misses, 1, __ATOMIC_RELAXED);
+		STATS_COUNT("cache_misses", 1);
+	}
+	return hit;
+}
+
+int rcache_put(rcache_t *c, const rcache_key_t *key, const long long *answers,
+	       int n)
+{
+	char path[4096];
+	char tmp[4096];
+	int ret = 0;
+
+	if (n > RCACHE_MAX_ANSWERS)
+		return -1;
+
+	rcache_path(c, key, path, sizeof(path));
+	snprintf(tmp, sizeof(tmp), "%s/.tmp-XXXXXX", c->dir);
+
+	int fd = mkstemp(tmp);
+	if (fd < 0) {
+		perror("Failed to create cache entry");
+		return -1;
+	}
+
+	FILE *f = fdopen(fd, "w");
+	if (!f) {
+		perror("Failed to create cache entry");
+		close(fd);
+		ret = -1;
+		goto unlink_tmp;
+	}
+
+	fprintf(f, "%llu %d", (unsigned long long)key->len, n);
+	for (int i = 0; i < n; i++)
+		fprintf(f, " %lld", answers[i]);
+	fprintf(f, "\n");
+
+	if (fclose(f) != 0) {
+		perror("Failed to write cache entry");
+		ret = -1;
+		goto unlink_tmp;
+	}
+
+	// rename() replaces the entry atomically, even with concurrent writers
+	if (rename(tmp, path) < 0) {
+		perror("Failed to store cache entry");
+		ret = -1;
+		goto unlink_tmp;
+	}
+
+	__atomic_fetch_add(&c->stores, 1, __ATOMIC_RELAXED);
+	return 0;
+
+unlink_tmp:
+	unlink(tmp);
+	return ret;
+}
+
+int rcache_clear(rcache_t *c, const char *solver)
+{
+	DIR *dir = opendir(c->dir);
+	struct dirent *ent;
+	size_t prefix = solver ? strlen(solver) : 0;
+	int removed = 0;
+
+	if (!dir) {
+		perror("Failed to open cache directory");
+		return -1;
+	}
+
+	while ((ent = readdir(dir)) != NULL) {
+		const char *name = ent->d_name;
+		char path[4096];
+
+		if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+			continue;
+
+		// Temporaries start with a dot; one may belong to a writer still
+		// running, so they are only swept when clearing everything
+		if (solver && (name[0] == '.' || strncmp(name, solver, prefix) != 0 ||
+			       name[prefix] != '-'))
+			continue;
+
+		snprintf(path, sizeof(path), "%s/%s", c->dir, name);
+		if (unlink(path) == 0 && name[0] != '.')
+			removed++;
+	}
+
+	closedir(dir);
+	return removed;
+}
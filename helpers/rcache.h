@@ -0,0 +1,127 @@
+#ifndef RCACHE_H
+#define RCACHE_H
+
+#include <stddef.h> // For size_t
+#include <stdint.h>
+
+/// Directory used when none is given and RCACHE_DIR is not set
+#define RCACHE_DEFAULT_DIR ".rcache"
+
+/// Most answers stored per entry
+#define RCACHE_MAX_ANSWERS 8
+
+/// Solver ids of the days, bump a version whenever its answers could change
+#define RCACHE_DAY1 "day-1.v1"
+#define RCACHE_DAY2 "day-2.v1"
+#define RCACHE_DAY3 "day-3.v1"
+
+/// On-disk cache of solver answers, keyed by input content
+typedef struct {
+	char *dir; // Directory holding one file per entry
+	uint64_t hits; // Lookups answered from the cache
+	uint64_t misses; // Lookups that found no valid entry
+	uint64_t stores; // Entries written
+} rcache_t;
+
+/// What the --cache flags asked for, see rcache_parse_arg()
+typedef struct {
+	int use; // Any of the flags was given
+	int clear; // --cache-clear was given
+	const char *dir; // From --cache=DIR, NULL: $RCACHE_DIR or RCACHE_DEFAULT_DIR
+} rcache_opts_t;
+
+/// What an entry is looked up by
+typedef struct {
+	const char *solver; // Solver id and version, e.g. "day-1.v1"; no '/'
+	uint64_t hash; // hash_bytes() of the input
+	size_t len; // Input length, checked on lookup to catch hash collisions
+} rcache_key_t;
+
+/**
+ * Opens a cache directory, creating it if needed.
+ *
+ * @param c The cache to initialize.
+ * @param dir Directory, or NULL for $RCACHE_DIR, falling back to
+ *            RCACHE_DEFAULT_DIR.
+ * @return 0 on success, -1 if the directory cannot be created.
+ */
+int rcache_open(rcache_t *c, const char *dir);
+
+/**
+ * Handles the --cache, --cache=DIR and --cache-clear command line flags.
+ *
+ * @param arg One command line argument.
+ * @param opts Updated when arg is one of the flags, zero-initialize it first.
+ * @return 1 if arg was a cache flag, 0 otherwise.
+ */
+int rcache_parse_arg(const char *arg, rcache_opts_t *opts);
+
+/**
+ * Opens the cache as the flags ask and clears one solver's entries on
+ * --cache-clear. A streamed input is never looked up, as the key needs all
+ * of its bytes at once, but --cache-clear is still honored for it.
+ *
+ * @param c The cache to initialize.
+ * @param opts The flags, see rcache_parse_arg().
+ * @param solver Solver id and version, e.g. RCACHE_DAY1.
+ * @param stream Non-zero when the input is streamed.
+ * @return 1 if c is open and to be used, 0 if caching is off (c is then
+ *         closed), -1 if the directory cannot be created.
+ */
+int rcache_open_solver(rcache_t *c, const rcache_opts_t *opts,
+		       const char *solver, int stream);
+
+/**
+ * Releases the cache handle. Entries stay on disk.
+ *
+ * @param c The cache.
+ */
+void rcache_close(rcache_t *c);
+
+/**
+ * Builds the key of an input: its hash and length, for one solver version.
+ * Bumping the version in the solver id invalidates every older entry.
+ *
+ * @param solver Solver id and version.
+ * @param begin First byte of the input.
+ * @param end One past the last byte of the input.
+ * @return The key.
+ */
+rcache_key_t rcache_key(const char *solver, const char *begin, const char *end);
+
+/**
+ * Looks up the answers for a key. Missing, truncated or mismatching entries
+ * count as misses.
+ *
+ * @param c The cache.
+ * @param key The key.
+ * @param answers Set to the stored answers on a hit.
+ * @param n Number of answers expected, at most RCACHE_MAX_ANSWERS.
+ * @return 1 on a hit, 0 on a miss.
+ */
+int rcache_get(rcache_t *c, const rcache_key_t *key, long long *answers, int n);
+
+/**
+ * Stores the answers for a key. The entry is written to a temporary file
+ * and renamed into place, so readers, including other processes, see either
+ * no entry or a complete one.
+ *
+ * @param c The cache.
+ * @param key The key.
+ * @param answers The answers.
+ * @param n Number of answers, at most RCACHE_MAX_ANSWERS.
+ * @return 0 on success, -1 on failure (the cache is left unchanged).
+ */
+int rcache_put(rcache_t *c, const rcache_key_t *key, const long long *answers,
+	       int n);
+
+/**
+ * Removes the entries of one solver, or every entry.
+ *
+ * @param c The cache.
+ * @param solver Solver id and version, or NULL for all solvers.
+ * @return Number of entries removed, or -1 if the directory cannot be read.
+ */
+int rcache_clear(rcache_t *c, const char *solver);
+
+#endif // RCACHE_H
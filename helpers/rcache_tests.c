@@ -0,0 +1,123 @@
+#include "rcache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+
+static char dir[] = "/tmp/rcache_tests.XXXXXX";
+
+void test_miss_then_hit(void)
+{
+	rcache_t c;
+	const char input[] = "3   4\n4   3\n";
+	long long answers[2] = { 11, 31 };
+	long long found[2] = { 0, 0 };
+
+	assert(rcache_open(&c, dir) == 0);
+	rcache_key_t key = rcache_key("test.v1", input, input + sizeof(input) - 1);
+
+	assert(rcache_get(&c, &key, found, 2) == 0);
+	assert(rcache_put(&c, &key, answers, 2) == 0);
+	assert(rcache_get(&c, &key, found, 2) == 1);
+	assert(found[0] == 11 && found[1] == 31);
+
+	// Same bytes under another solver version is another entry
+	rcache_key_t v2 = rcache_key("test.v2", input, input + sizeof(input) - 1);
+	assert(rcache_get(&c, &v2, found, 2) == 0);
+
+	// A different answer count does not match
+	assert(rcache_get(&c, &key, found, 3) == 0);
+
+	assert(c.hits == 1 && c.misses == 3 && c.stores == 1);
+	rcache_close(&c);
+	printf("test_miss_then_hit passed.\n");
+}
+
+void test_collision_guard(void)
+{
+	rcache_t c;
+	long long answers[1] = { 42 };
+	long long found[1];
+
+	assert(rcache_open(&c, dir) == 0);
+
+	// Same hash, different length: treated as a collision
+	rcache_key_t key = { "guard.v1", 1234, 10 };
+	rcache_key_t other = { "guard.v1", 1234, 11 };
+	assert(rcache_put(&c, &key, answers, 1) == 0);
+	assert(rcache_get(&c, &other, found, 1) == 0);
+	assert(rcache_get(&c, &key, found, 1) == 1 && found[0] == 42);
+
+	rcache_close(&c);
+	printf("test_collision_guard passed.\n");
+}
+
+void test_clear(void)
+{
+	rcache_t c;
+	long long answers[1] = { 7 };
+	long long found[1];
+
+	assert(rcache_open(&c, dir) == 0);
+
+	rcache_key_t a = { "clear.v1", 1, 1 };
+	rcache_key_t b = { "clear.v10", 1, 1 };
+	assert(rcache_put(&c, &a, answers, 1) == 0);
+	assert(rcache_put(&c, &b, answers, 1) == 0);
+
+	// Only the exact solver id goes, not ids it is a prefix of
+	assert(rcache_clear(&c, "clear.v1") == 1);
+	assert(rcache_get(&c, &a, found, 1) == 0);
+	assert(rcache_get(&c, &b, found, 1) == 1);
+
+	assert(rcache_clear(&c, NULL) >= 1);
+	assert(rcache_get(&c, &b, found, 1) == 0);
+
+	rcache_close(&c);
+	printf("test_clear passed.\n");
+}
+
+void test_open_solver(void)
+{
+	rcache_opts_t opts = { 0 };
+	rcache_t c;
+	long long answers[1] = { 7 };
+	long long found[1];
+	rcache_key_t key = { "solver.v1", 1, 1 };
+
+	assert(rcache_open_solver(&c, &opts, "solver.v1", 0) == 0);
+
+	assert(rcache_parse_arg("--cache=x", &opts) == 1 && opts.use);
+	assert(strcmp(opts.dir, "x") == 0);
+	assert(rcache_parse_arg("--cached", &opts) == 0);
+	opts.dir = dir;
+
+	assert(rcache_open_solver(&c, &opts, "solver.v1", 0) == 1);
+	assert(rcache_put(&c, &key, answers, 1) == 0);
+	rcache_close(&c);
+
+	// Streamed inputs skip the cache, but still clear it when asked
+	assert(rcache_open_solver(&c, &opts, "solver.v1", 1) == 0);
+	assert(rcache_parse_arg("--cache-clear", &opts) == 1 && opts.clear);
+	assert(rcache_open_solver(&c, &opts, "solver.v1", 1) == 0);
+
+	assert(rcache_open(&c, dir) == 0);
+	assert(rcache_get(&c, &key, found, 1) == 0);
+	rcache_close(&c);
+	printf("test_open_solver passed.\n");
+}
+
+int main(void)
+{
+	assert(mkdtemp(dir));
+
+	test_miss_then_hit();
+	test_collision_guard();
+	test_clear();
+	test_open_solver();
+
+	rmdir(dir);
+	printf("All tests passed.\n");
+	return 0;
+}
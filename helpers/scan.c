@@ -0,0 +1,104 @@
+#include <stdint.h>
+#include <string.h>
+#include "helpers.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SCAN_SWAR 1
+#endif
+
+static inline int scan_isdigit(char c)
+{
+	return (unsigned char)(c - '0') < 10;
+}
+
+#ifdef SCAN_SWAR
+/// Number of leading ASCII digits in the 8 bytes of chunk (first byte is the lowest)
+static inline int swar_digit_run(uint64_t chunk)
+{
+	uint64_t x = chunk ^ 0x3030303030303030ULL; // Digits become 0..9
+	uint64_t non_digit = (((x & 0x7f7f7f7f7f7f7f7fULL) + 0x7676767676767676ULL) | x) &
+			     0x8080808080808080ULL;
+
+	return non_digit ? __builtin_ctzll(non_digit) / 8 : 8;
+}
+
+/// Value of the first n (1..8) digits in chunk, 8 digits combined with 3 multiplies
+static inline uint32_t swar_digits_value(uint64_t chunk, int n)
+{
+	uint64_t x = chunk - 0x3030303030303030ULL;
+
+	// Shift the digits to the top so the low bytes act as leading zeros
+	if (n < 8)
+		x <<= 8 * (8 - n);
+
+	x = (x * 10) + (x >> 8);
+	x = (((x & 0x000000ff000000ffULL) * (100 + (1000000ULL << 32))) +
+	     (((x >> 16) & 0x000000ff000000ffULL) * (1 + (10000ULL << 32)))) >>
+	    32;
+	return (uint32_t)x;
+}
+#endif
+
+const char *scan_uint(const char *p, const char *end, unsigned *out)
+{
+	while (p < end && (*p == ' ' || *p == '\t'))
+		p++;
+
+	if (p == end || !scan_isdigit(*p))
+		return NULL;
+
+	unsigned value = 0;
+
+#ifdef SCAN_SWAR
+	static const unsigned pow10[] = { 1,	  10,	   100,	     1000,
+					  10000,  100000,  1000000,  10000000,
+					  100000000 };
+
+	while (end - p >= 8) {
+		uint64_t chunk;
+		memcpy(&chunk, p, sizeof(chunk));
+
+		int n = swar_digit_run(chunk);
+		if (n == 0)
+			break;
+
+		value = value * pow10[n] + swar_digits_value(chunk, n);
+		p += n;
+
+		if (n < 8) { // Hit the end of the run
+			*out = value;
+			return p;
+		}
+	}
+#endif
+
+	while (p < end && scan_isdigit(*p))
+		value = value * 10 + (*p++ - '0');
+
+	*out = value;
+	return p;
+}
+
+const char *scan_int(const char *p, const char *end, int *out)
+{
+	while (p < end && (*p == ' ' || *p == '\t'))
+		p++;
+
+	int neg = 0;
+	if (p < end && (*p == '-' || *p == '+')) {
+		neg = (*p == '-');
+		p++;
+
+		// A sign must be followed directly by a digit
+		if (p == end || !scan_isdigit(*p))
+			return NULL;
+	}
+
+	unsigned value;
+	p = scan_uint(p, end, &value);
+	if (!p)
+		return NULL;
+
+	*out = neg ? (int)(0u - value) : (int)value;
+	return p;
+}
@@ -0,0 +1,200 @@
+#include "sort.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (32 / RADIX_BITS)
+#define RADIX_MT_MIN (1 << 16) // Below this, threads cost more than they save
+
+/// Flip the sign bit so signed ints order correctly as unsigned keys
+static inline uint32_t radix_key(int v)
+{
+	return (uint32_t)v ^ 0x80000000u;
+}
+
+static inline unsigned radix_digit(int v, int pass)
+{
+	return (radix_key(v) >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1);
+}
+
+static int *radix_scratch(size_t n)
+{
+	int *tmp = malloc(sizeof(int) * n);
+	if (!tmp) {
+		fprintf(stderr, "ERROR: Failed to allocate sort buffer\n");
+		exit(EXIT_FAILURE);
+	}
+	return tmp;
+}
+
+void radix_sort_int(int *a, size_t n)
+{
+	size_t hist[RADIX_PASSES][RADIX_BUCKETS] = { { 0 } };
+
+	if (n < 2)
+		return;
+
+	// One read of the input builds the histograms for every pass
+	for (size_t i = 0; i < n; i++) {
+		uint32_t k = radix_key(a[i]);
+		for (int pass = 0; pass < RADIX_PASSES; pass++)
+			hist[pass][(k >> (pass * RADIX_BITS)) &
+				   (RADIX_BUCKETS - 1)]++;
+	}
+
+	int *tmp = radix_scratch(n);
+	int *src = a, *dst = tmp;
+
+	for (int pass = 0; pass < RADIX_PASSES; pass++) {
+		size_t *h = hist[pass];
+
+		if (h[radix_digit(src[0], pass)] == n) // Digit is constant
+			continue;
+
+		size_t sum = 0;
+		for (int b = 0; b < RADIX_BUCKETS; b++) {
+			size_t c = h[b];
+			h[b] = sum;
+			sum += c;
+		}
+
+		for (size_t i = 0; i < n; i++)
+			dst[h[radix_digit(src[i], pass)]++] = src[i];
+
+		int *swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != a)
+		memcpy(a, src, sizeof(int) * n);
+
+	free(tmp);
+}
+
+/// State shared by the threads of one radix_sort_int_mt() call
+typedef struct {
+	int *bufs[2];
+	size_t n;
+	int threads;
+	size_t (*hist)[RADIX_BUCKETS]; // One histogram per thread
+	int skip; // Current pass has a constant digit
+	int result; // Index into bufs of the sorted output
+	pthread_barrier_t barrier;
+} radix_mt_t;
+
+typedef struct {
+	radix_mt_t *shared;
+	int id;
+} radix_mt_arg_t;
+
+static void *radix_mt_worker(void *arg)
+{
+	radix_mt_arg_t *w = arg;
+	radix_mt_t *s = w->shared;
+	size_t lo = s->n * w->id / s->threads;
+	size_t hi = s->n * (w->id + 1) / s->threads;
+	size_t *h = s->hist[w->id];
+	int cur = 0;
+
+	for (int pass = 0; pass < RADIX_PASSES; pass++) {
+		const int *src = s->bufs[cur];
+		int *dst = s->bufs[cur ^ 1];
+
+		memset(h, 0, sizeof(size_t) * RADIX_BUCKETS);
+		for (size_t i = lo; i < hi; i++)
+			h[radix_digit(src[i], pass)]++;
+
+		pthread_barrier_wait(&s->barrier);
+
+		// One thread turns the histograms into per-thread scatter offsets:
+		// bucket b of thread t starts after all smaller buckets and after
+		// bucket b of every thread before t, which keeps the sort stable
+		if (w->id == 0) {
+			size_t sum = 0;
+			s->skip = 0;
+			for (int b = 0; b < RADIX_BUCKETS; b++) {
+				size_t bucket = 0;
+				for (int t = 0; t < s->threads; t++) {
+					size_t c = s->hist[t][b];
+					s->hist[t][b] = sum;
+					sum += c;
+					bucket += c;
+				}
+				if (bucket == s->n)
+					s->skip = 1;
+			}
+		}
+
+		pthread_barrier_wait(&s->barrier);
+
+		if (!s->skip) {
+			for (size_t i = lo; i < hi; i++)
+				dst[h[radix_digit(src[i], pass)]++] = src[i];
+			cur ^= 1;
+		}
+
+		// Nobody may start the next histogram before the scatter is done
+		pthread_barrier_wait(&s->barrier);
+	}
+
+	if (w->id == 0)
+		s->result = cur;
+
+	return NULL;
+}
+
+void radix_sort_int_mt(int *a, size_t n, int threads)
+{
+	if (threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (threads <= 1 || n < RADIX_MT_MIN) {
+		radix_sort_int(a, n);
+		return;
+	}
+
+	radix_mt_t s = {
+		.bufs = { a, radix_scratch(n) },
+		.n = n,
+		.threads = threads,
+	};
+	radix_mt_arg_t *args = malloc(sizeof(*args) * threads);
+	pthread_t *tids = malloc(sizeof(*tids) * threads);
+	s.hist = malloc(sizeof(*s.hist) * threads);
+	if (!args || !tids || !s.hist) {
+		fprintf(stderr, "ERROR: Failed to allocate sort threads\n");
+		exit(EXIT_FAILURE);
+	}
+
+	pthread_barrier_init(&s.barrier, NULL, threads);
+
+	for (int t = 0; t < threads; t++) {
+		args[t].shared = &s;
+		args[t].id = t;
+		if (t && pthread_create(&tids[t], NULL, radix_mt_worker,
+					&args[t]) != 0) {
+			fprintf(stderr, "ERROR: Failed to start sort thread\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	radix_mt_worker(&args[0]); // The caller is thread 0
+
+	for (int t = 1; t < threads; t++)
+		pthread_join(tids[t], NULL);
+
+	if (s.result != 0)
+		memcpy(a, s.bufs[1], sizeof(int) * n);
+
+	pthread_barrier_destroy(&s.barrier);
+	free(s.hist);
+	free(tids);
+	free(args);
+	free(s.bufs[1]);
+}
@@ -0,0 +1,32 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <stddef.h> // For size_t
+
+/**
+ * Sorts 32-bit ints ascending with an LSD radix sort (four 8-bit passes).
+ *
+ * Passes where every key has the same digit are skipped, so small ranges
+ * (e.g. 5-digit ids) only pay for the bytes that actually vary. Uses a
+ * scratch buffer of n ints.
+ *
+ * @param a Array to sort in place.
+ * @param n Number of elements in a.
+ */
+void radix_sort_int(int *a, size_t n);
+
+/**
+ * Parallel variant of radix_sort_int().
+ *
+ * Every pass is split across threads: each one builds a histogram of its
+ * slice, the histograms are combined into per-thread bucket offsets, then
+ * all threads scatter their slice at once. Falls back to radix_sort_int()
+ * for small inputs or a single thread.
+ *
+ * @param a Array to sort in place.
+ * @param n Number of elements in a.
+ * @param threads Number of threads to use, 0 for one per online CPU.
+ */
+void radix_sort_int_mt(int *a, size_t n, int threads);
+
+#endif // SORT_H
@@ -0,0 +1,91 @@
+#include "sort.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// One sort engine on one input
+typedef struct {
+	const int *input;
+	int *work; // Sorted in place, refilled from input every round
+	size_t n;
+	int engine; // Index into names
+} sort_job_t;
+
+static const char *names[] = { "qsort", "radix", "radix_mt" };
+
+static int compare_int(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+	return (x > y) - (x < y);
+}
+
+/// Includes restoring the input, every engine sorts in place
+static void run_sort(void *arg)
+{
+	sort_job_t *job = arg;
+
+	memcpy(job->work, job->input, sizeof(int) * job->n);
+	if (job->engine == 0)
+		qsort(job->work, job->n, sizeof(int), compare_int);
+	else if (job->engine == 1)
+		radix_sort_int(job->work, job->n);
+	else
+		radix_sort_int_mt(job->work, job->n, 0);
+}
+
+static void run(const char *label, const int *input, size_t n)
+{
+	int *expected = malloc(sizeof(int) * n);
+	int *work = malloc(sizeof(int) * n);
+	double median[3];
+	char name[64];
+
+	if (!expected || !work) {
+		fprintf(stderr, "ERROR: Failed to allocate %zu ints\n", n);
+		exit(EXIT_FAILURE);
+	}
+
+	for (int k = 0; k < 3; k++) {
+		sort_job_t job = { input, k ? work : expected, n, k };
+
+		snprintf(name, sizeof(name), "sort/%s/%s", names[k], label);
+		median[k] = bench_run(name, n * sizeof(int), run_sort, &job);
+
+		if (k && memcmp(work, expected, sizeof(int) * n)) {
+			fprintf(stderr, "ERROR: %s/%s result differs from qsort\n",
+				names[k], label);
+			exit(EXIT_FAILURE);
+		}
+	}
+	bench_note("%-28s %.1fx faster than qsort", label, median[0] / median[1]);
+
+	free(expected);
+	free(work);
+}
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) :
+			      bench_scaled(10000000);
+	int *input = malloc(sizeof(int) * n);
+	unsigned state = 42;
+
+	if (!input) {
+		fprintf(stderr, "ERROR: Failed to allocate %zu ints\n", n);
+		return 1;
+	}
+
+	// Day-1 shaped columns: 5-digit ids, only the low 3 bytes vary
+	for (size_t i = 0; i < n; i++)
+		input[i] = 10000 + bench_rand(&state) % 90000;
+	run("5digit", input, n);
+
+	// Full 32-bit range including negatives, all four passes
+	for (size_t i = 0; i < n; i++)
+		input[i] = (int)bench_rand(&state);
+	run("full", input, n);
+
+	free(input);
+	return 0;
+}
@@ -0,0 +1,158 @@
+#include "stats.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/// Maximum number of distinct phases and counters
+#define STATS_MAX 64
+
+/// One named phase or counter
+typedef struct {
+	const char *name;
+	stats_kind_t kind;
+	uint64_t value; // Nanoseconds for phases, the count for counters
+	uint64_t calls; // Times a phase was entered
+} stats_entry_t;
+
+static stats_entry_t stats_entries[STATS_MAX];
+static int stats_used;
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t stats_now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+int stats_id(int *cache, const char *name, stats_kind_t kind)
+{
+	int id = __atomic_load_n(cache, __ATOMIC_ACQUIRE);
+	if (id >= 0)
+		return id;
+
+	pthread_mutex_lock(&stats_lock);
+
+	// Same name from another call site shares the entry
+	for (id = 0; id < stats_used; id++) {
+		if (stats_entries[id].kind == kind &&
+		    strcmp(stats_entries[id].name, name) == 0)
+			break;
+	}
+
+	if (id == stats_used) {
+		if (stats_used < STATS_MAX) {
+			stats_entries[id].name = name;
+			stats_entries[id].kind = kind;
+			stats_used++;
+		} else {
+			id = -1;
+		}
+	}
+
+	pthread_mutex_unlock(&stats_lock);
+
+	if (id >= 0)
+		__atomic_store_n(cache, id, __ATOMIC_RELEASE);
+	return id;
+}
+
+void stats_add(int id, uint64_t n)
+{
+	if (id >= 0)
+		__atomic_fetch_add(&stats_entries[id].value, n,
+				   __ATOMIC_RELAXED);
+}
+
+stats_timer_t stats_timer_begin(int id)
+{
+	stats_timer_t t = { id, stats_now_ns() };
+	return t;
+}
+
+void stats_timer_end(stats_timer_t *t)
+{
+	if (t->id < 0)
+		return;
+
+	stats_add(t->id, stats_now_ns() - t->start);
+	__atomic_fetch_add(&stats_entries[t->id].calls, 1, __ATOMIC_RELAXED);
+}
+
+uint64_t stats_value(const char *name, stats_kind_t kind)
+{
+	int n = __atomic_load_n(&stats_used, __ATOMIC_ACQUIRE);
+
+	for (int i = 0; i < n; i++) {
+		const stats_entry_t *e = &stats_entries[i];
+		if (e->kind == kind && strcmp(e->name, name) == 0)
+			return __atomic_load_n(&e->value, __ATOMIC_RELAXED);
+	}
+	return 0;
+}
+
+int stats_parse_arg(const char *arg, stats_mode_t *mode)
+{
+	if (strcmp(arg, "--stats") == 0)
+		*mode = STATS_TABLE;
+	else if (strcmp(arg, "--stats=json") == 0)
+		*mode = STATS_JSON;
+	else
+		return 0;
+	return 1;
+}
+
+void stats_print(int json)
+{
+	int n = __atomic_load_n(&stats_used, __ATOMIC_ACQUIRE);
+
+	if (json) {
+		const char *sep = "";
+
+		fprintf(stderr, "{\"phases\":{");
+		for (int i = 0; i < n; i++) {
+			const stats_entry_t *e = &stats_entries[i];
+			if (e->kind != STATS_PHASE)
+				continue;
+			fprintf(stderr,
+				"%s\"%s\":{\"calls\":%llu,\"seconds\":%.9f}",
+				sep, e->name, (unsigned long long)e->calls,
+				e->value * 1e-9);
+			sep = ",";
+		}
+
+		sep = "";
+		fprintf(stderr, "},\"counters\":{");
+		for (int i = 0; i < n; i++) {
+			const stats_entry_t *e = &stats_entries[i];
+			if (e->kind != STATS_COUNTER)
+				continue;
+			fprintf(stderr, "%s\"%s\":%llu", sep, e->name,
+				(unsigned long long)e->value);
+			sep = ",";
+		}
+		fprintf(stderr, "}}\n");
+		return;
+	}
+
+#ifdef NSTATS
+	if (n == 0)
+		fprintf(stderr, "stats: built with -DNSTATS, nothing recorded\n");
+#endif
+
+	for (int i = 0; i < n; i++) {
+		const stats_entry_t *e = &stats_entries[i];
+		if (e->kind == STATS_PHASE)
+			fprintf(stderr, "phase   %-24s %8llu calls %12.6f s\n",
+				e->name, (unsigned long long)e->calls,
+				e->value * 1e-9);
+	}
+
+	for (int i = 0; i < n; i++) {
+		const stats_entry_t *e = &stats_entries[i];
+		if (e->kind == STATS_COUNTER)
+			fprintf(stderr, "counter %-24s %20llu\n", e->name,
+				(unsigned long long)e->value);
+	}
+}
@@ -0,0 +1,119 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+
+/// What a stats entry measures
+typedef enum {
+	STATS_PHASE, // Time spent in a scope, summed over calls and threads
+	STATS_COUNTER // Free-form count: lines parsed, bytes scanned, ...
+} stats_kind_t;
+
+/// What --stats asked for, see stats_parse_arg()
+typedef enum {
+	STATS_OFF, // No report
+	STATS_TABLE, // --stats: a table on stderr
+	STATS_JSON // --stats=json: one JSON object on stderr
+} stats_mode_t;
+
+/// A running phase timer, see STATS_SCOPE()
+typedef struct {
+	int id; // Entry the elapsed time goes to
+	uint64_t start; // Monotonic start time in nanoseconds
+} stats_timer_t;
+
+/**
+ * Returns the entry index for a name, registering it on first use. The
+ * index is cached in *cache, so each call site looks the name up only once.
+ * Thread-safe.
+ *
+ * @param cache Per call site cache, initialized to -1.
+ * @param name Entry name, must outlive the program (a string literal).
+ * @param kind Whether the entry is a phase or a counter.
+ * @return The entry index, or -1 if the table is full.
+ */
+int stats_id(int *cache, const char *name, stats_kind_t kind);
+
+/**
+ * Adds n to an entry with an atomic add, so worker threads may count too.
+ *
+ * @param id Entry index from stats_id(), -1 is ignored.
+ * @param n Amount to add.
+ */
+void stats_add(int id, uint64_t n);
+
+/**
+ * Starts timing a phase.
+ *
+ * @param id Entry index from stats_id().
+ * @return The running timer, to pass to stats_timer_end().
+ */
+stats_timer_t stats_timer_begin(int id);
+
+/**
+ * Stops a phase timer and adds the elapsed time and one call to its entry.
+ *
+ * @param t The timer.
+ */
+void stats_timer_end(stats_timer_t *t);
+
+/**
+ * Returns the value of an entry: nanoseconds for a phase, the count for a
+ * counter.
+ *
+ * @param name Entry name.
+ * @param kind Whether the entry is a phase or a counter.
+ * @return The value, or 0 if no such entry was recorded.
+ */
+uint64_t stats_value(const char *name, stats_kind_t kind);
+
+/**
+ * Prints every phase (calls and seconds) and counter to stderr, as a table
+ * or as a single JSON object.
+ *
+ * @param json Non-zero for JSON.
+ */
+void stats_print(int json);
+
+/**
+ * Handles the --stats and --stats=json command line flags.
+ *
+ * @param arg One command line argument.
+ * @param mode Set to the requested report when arg is one of the flags.
+ * @return 1 if arg was a stats flag, 0 otherwise.
+ */
+int stats_parse_arg(const char *arg, stats_mode_t *mode);
+
+#define STATS_CAT_(a, b) a##b
+#define STATS_CAT(a, b) STATS_CAT_(a, b)
+
+#ifndef NSTATS
+
+/**
+ * Times the rest of the enclosing scope as phase `name`; the timer stops
+ * when the scope is left, however that happens.
+ *
+ * Build with -DNSTATS to compile every STATS_* macro out.
+ */
+#define STATS_SCOPE(name)                                                      \
+	static int STATS_CAT(stats_id_, __LINE__) = -1;                        \
+	stats_timer_t STATS_CAT(stats_timer_, __LINE__)                        \
+		__attribute__((cleanup(stats_timer_end))) = stats_timer_begin( \
+			stats_id(&STATS_CAT(stats_id_, __LINE__), name,        \
+				 STATS_PHASE))
+
+/// Adds n to counter `name`
+#define STATS_COUNT(name, n)                                                   \
+	do {                                                                   \
+		static int stats_id_ = -1;                                     \
+		stats_add(stats_id(&stats_id_, name, STATS_COUNTER), (n));     \
+	} while (0)
+
+#else
+
+#define STATS_SCOPE(name) (void)0
+#define STATS_COUNT(name, n) ((void)sizeof(n)) // Keeps n used, unevaluated
+
+#endif // NSTATS
+
+#endif // STATS_H
@@ -0,0 +1,76 @@
+#include "stats.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <assert.h>
+
+static void *count_worker(void *arg)
+{
+	(void)arg;
+	for (int i = 0; i < 1000; i++)
+		STATS_COUNT("test_threads", 1);
+	return NULL;
+}
+
+void test_counter(void)
+{
+	for (int i = 0; i < 3; i++)
+		STATS_COUNT("test_counter", 5);
+
+	// A second call site with the same name shares the entry
+	STATS_COUNT("test_counter", 1);
+
+	assert(stats_value("test_counter", STATS_COUNTER) == 16);
+	assert(stats_value("test_counter", STATS_PHASE) == 0);
+	assert(stats_value("missing", STATS_COUNTER) == 0);
+	printf("test_counter passed.\n");
+}
+
+void test_counter_threads(void)
+{
+	pthread_t tids[4];
+
+	for (int i = 0; i < 4; i++)
+		assert(pthread_create(&tids[i], NULL, count_worker, NULL) == 0);
+	for (int i = 0; i < 4; i++)
+		pthread_join(tids[i], NULL);
+
+	assert(stats_value("test_threads", STATS_COUNTER) == 4000);
+	printf("test_counter_threads passed.\n");
+}
+
+void test_scope(void)
+{
+	for (int i = 0; i < 2; i++) {
+		STATS_SCOPE("test_scope");
+		volatile unsigned x = 0;
+		for (unsigned j = 0; j < 100000; j++)
+			x += j;
+	}
+
+	assert(stats_value("test_scope", STATS_PHASE) > 0);
+	printf("test_scope passed.\n");
+}
+
+void test_parse_arg(void)
+{
+	stats_mode_t mode = STATS_OFF;
+
+	assert(stats_parse_arg("--stats", &mode) == 1 && mode == STATS_TABLE);
+	assert(stats_parse_arg("--stats=json", &mode) == 1 &&
+	       mode == STATS_JSON);
+	assert(stats_parse_arg("--stats=xml", &mode) == 0 &&
+	       mode == STATS_JSON);
+	assert(stats_parse_arg("data.input", &mode) == 0);
+	printf("test_parse_arg passed.\n");
+}
+
+int main(void)
+{
+	test_counter();
+	test_counter_threads();
+	test_scope();
+	test_parse_arg();
+	stats_print(0);
+	printf("All tests passed.\n");
+	return 0;
+}
@@ -0,0 +1,100 @@
+#ifndef TVEC_H
+#define TVEC_H
+
+#include <assert.h>
+#include <stddef.h> // For size_t
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Defines a typed dynamic vector `name##_t` holding elements of `type`, with
+ * `static inline` operations prefixed by `name##_`.
+ *
+ * Unlike vec_t, the element size is known at compile time, so name##_at() is
+ * one indexed address computation and name##_push() one store in the common
+ * case. Elements are copied by assignment; nothing they point to is owned.
+ *
+ * A zero-initialized vector is valid and empty, so no init call is needed.
+ *
+ * @param name Prefix for the struct and its functions.
+ * @param type Element type.
+ *
+ * @code{.c}
+ * TVEC_DEFINE(dvec, double)
+ *
+ * dvec_t v = { 0 };
+ * dvec_push(&v, 1.5);
+ * printf("%f\n", *dvec_at(&v, 0));
+ * dvec_free(&v);
+ * @endcode
+ */
+#define TVEC_DEFINE(name, type)                                                \
+	typedef struct {                                                       \
+		type *data; /* Pointer to the array of elements */             \
+		size_t size; /* Current number of elements */                  \
+		size_t cap; /* Capacity of the vector */                       \
+	} name##_t;                                                            \
+                                                                               \
+	/* Release the storage and leave an empty vector behind */             \
+	static inline void name##_free(name##_t *v)                            \
+	{                                                                      \
+		free(v->data);                                                 \
+		v->data = NULL;                                                \
+		v->size = v->cap = 0;                                          \
+	}                                                                      \
+                                                                               \
+	/* Make room for at least cap elements */                              \
+	static inline void name##_reserve(name##_t *v, size_t cap)             \
+	{                                                                      \
+		if (cap <= v->cap)                                             \
+			return;                                                \
+                                                                               \
+		type *new_data = realloc(v->data, cap * sizeof(type));         \
+		if (!new_data) {                                               \
+			fprintf(stderr, "ERROR: Failed to resize vector\n");   \
+			exit(EXIT_FAILURE);                                    \
+		}                                                              \
+		v->data = new_data;                                            \
+		v->cap = cap;                                                  \
+	}                                                                      \
+                                                                               \
+	/* Out of line so the growth path stays out of name##_push */          \
+	static __attribute__((noinline)) void name##_grow(name##_t *v)         \
+	{                                                                      \
+		name##_reserve(v, v->cap ? v->cap * 2 : 8);                    \
+	}                                                                      \
+                                                                               \
+	static inline void name##_push(name##_t *v, type item)                 \
+	{                                                                      \
+		if (v->size == v->cap)                                         \
+			name##_grow(v);                                        \
+		v->data[v->size++] = item;                                     \
+	}                                                                      \
+                                                                               \
+	static inline type name##_pop(name##_t *v)                             \
+	{                                                                      \
+		assert(v->size > 0 && "Vector is empty");                      \
+		return v->data[--v->size];                                     \
+	}                                                                      \
+                                                                               \
+	static inline type *name##_at(const name##_t *v, size_t index)         \
+	{                                                                      \
+		assert(index < v->size && "Index out of bounds");              \
+		return &v->data[index];                                        \
+	}                                                                      \
+                                                                               \
+	static inline size_t name##_size(const name##_t *v)                    \
+	{                                                                      \
+		return v->size;                                                \
+	}                                                                      \
+                                                                               \
+	/* Drop all elements, keeping the capacity */                          \
+	static inline void name##_clear(name##_t *v)                           \
+	{                                                                      \
+		v->size = 0;                                                   \
+	}
+
+/// Vector of int, the common case for puzzle inputs
+TVEC_DEFINE(ivec, int)
+
+#endif // TVEC_H
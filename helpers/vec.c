@@ -1,4 +1,5 @@
 #include "vec.h"
+#include "stats.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -24,45 +25,110 @@ static size_t vec_type_size(vec_type_t type)
 	}
 }
 
-/// Allocate and initialize a new vector
-vec_t *vec_create(vec_type_t type)
+/// Default growth policy: double until there is room
+static size_t vec_grow_double(size_t cap, size_t needed)
+{
+	size_t new_cap = cap ? cap : 1;
+	while (new_cap < needed)
+		new_cap *= 2;
+	return new_cap;
+}
+
+static vec_growth_fn vec_growth = vec_grow_double;
+
+void vec_set_growth(vec_growth_fn growth)
+{
+	vec_growth = growth ? growth : vec_grow_double;
+}
+
+/// Resize ptr through the allocator hook, or realloc() without one
+static void *vec_mem_realloc(const vec_allocator_t *alloc, void *ptr,
+			     size_t old_size, size_t new_size)
 {
-	vec_t *v = malloc(sizeof(vec_t));
+	STATS_COUNT("vec_allocs", 1);
+	if (!alloc)
+		return realloc(ptr, new_size);
+	return alloc->realloc(alloc->ctx, ptr, old_size, new_size);
+}
+
+static void vec_mem_free(const vec_allocator_t *alloc, void *ptr)
+{
+	if (!alloc)
+		free(ptr);
+	else
+		alloc->free(alloc->ctx, ptr);
+}
+
+/// Allocate and initialize a new vector with room for cap elements in alloc
+vec_t *vec_create_in(vec_type_t type, size_t cap, const vec_allocator_t *alloc)
+{
+	vec_t *v = vec_mem_realloc(alloc, NULL, 0, sizeof(vec_t));
 	if (!v) {
 		fprintf(stderr,
 			"ERROR: Failed to allocate memory for vector\n");
 		exit(EXIT_FAILURE);
 	}
 
-	v->data =
-		malloc(vec_type_size(type) * 8); // Default initial capacity: 8
+	if (cap == 0)
+		cap = 1;
+
+	v->data = vec_mem_realloc(alloc, NULL, 0, vec_type_size(type) * cap);
 	if (!v->data) {
-		free(v);
+		vec_mem_free(alloc, v);
 		fprintf(stderr, "ERROR: Failed to allocate vector data\n");
 		exit(EXIT_FAILURE);
 	}
 
 	v->size = 0;
-	v->cap = 8;
+	v->cap = cap;
 	v->type = type;
+	v->alloc = alloc;
 	return v;
 }
 
+/// Allocate and initialize a new vector with room for cap elements
+vec_t *vec_create_with_capacity(vec_type_t type, size_t cap)
+{
+	return vec_create_in(type, cap, NULL);
+}
+
+/// Allocate and initialize a new vector
+vec_t *vec_create(vec_type_t type)
+{
+	return vec_create_with_capacity(type, 8); // Default initial capacity: 8
+}
+
+/// Release what the elements own. Nested vectors are stored inline, so only
+/// their contents are freed, never the vec_t itself.
+static void vec_release_elements(vec_t *v)
+{
+	if (v->type != TYPE_VEC)
+		return;
+
+	for (size_t i = 0; i < v->size; i++) {
+		vec_t *nested_vec = (vec_t *)vec_at(v, i);
+		vec_release_elements(nested_vec);
+		vec_mem_free(nested_vec->alloc, nested_vec->data);
+	}
+}
+
 /// Free memory associated with a vector
 void vec_destroy(vec_t *v)
 {
 	if (!v)
 		return;
 
-	if (v->type == TYPE_VEC) {
-		for (size_t i = 0; i < v->size; i++) {
-			vec_t *nested_vec = (vec_t *)vec_at(v, i);
-			vec_destroy(nested_vec);
-		}
-	}
+	vec_release_elements(v);
+	vec_mem_free(v->alloc, v->data);
+	vec_mem_free(v->alloc, v);
+}
 
-	free(v->data);
-	free(v);
+/// Remove all elements, keeping the allocated capacity
+void vec_clear(vec_t *v)
+{
+	assert(v);
+	vec_release_elements(v);
+	v->size = 0;
 }
 
 /// Get the size (number of elements) of the vector
@@ -84,20 +150,51 @@ void *vec_at(const vec_t *v, size_t index)
 	return (char *)v->data + index * vec_type_size(v->type);
 }
 
+/// Reallocate the storage to exactly new_cap elements
+static void vec_set_capacity(vec_t *v, size_t new_cap)
+{
+	size_t elem = vec_type_size(v->type);
+	void *new_data =
+		vec_mem_realloc(v->alloc, v->data, v->cap * elem, new_cap * elem);
+	if (!new_data) {
+		fprintf(stderr, "ERROR: Failed to resize vector\n");
+		exit(EXIT_FAILURE);
+	}
+	v->data = new_data;
+	v->cap = new_cap;
+}
+
+/// Make room for n more elements, growing by the current policy
+static void vec_resize_if_needed_n(vec_t *v, size_t n)
+{
+	if (v->size + n > v->cap) {
+		size_t new_cap = vec_growth(v->cap, v->size + n);
+		assert(new_cap >= v->size + n && "Growth policy too small");
+		vec_set_capacity(v, new_cap);
+	}
+}
+
 /// Resize vector if necessary to accommodate more elements
 static void vec_resize_if_needed(vec_t *v)
 {
-	if (v->size >= v->cap) {
-		size_t new_cap = v->cap * 2;
-		void *new_data =
-			realloc(v->data, new_cap * vec_type_size(v->type));
-		if (!new_data) {
-			fprintf(stderr, "ERROR: Failed to resize vector\n");
-			exit(EXIT_FAILURE);
-		}
-		v->data = new_data;
-		v->cap = new_cap;
-	}
+	vec_resize_if_needed_n(v, 1);
+}
+
+/// Grow to at least cap elements, never shrinking
+void vec_reserve(vec_t *v, size_t cap)
+{
+	assert(v);
+	if (cap > v->cap)
+		vec_set_capacity(v, cap);
+}
+
+/// Give back the unused capacity
+void vec_shrink_to_fit(vec_t *v)
+{
+	assert(v);
+	size_t cap = v->size ? v->size : 1;
+	if (cap < v->cap)
+		vec_set_capacity(v, cap);
 }
 
 /// Add an element to the end of the vector
@@ -110,6 +207,33 @@ void vec_push_back(vec_t *v, const void *item)
 	v->size++;
 }
 
+/// Append n elements with a single capacity check and copy
+void vec_push_n(vec_t *v, const void *items, size_t n)
+{
+	assert(v && (items || n == 0));
+	if (n == 0)
+		return;
+
+	vec_resize_if_needed_n(v, n);
+	memcpy((char *)v->data + v->size * vec_type_size(v->type), items,
+	       n * vec_type_size(v->type));
+	v->size += n;
+}
+
+/// Append all elements of another vector of the same type
+void vec_extend(vec_t *v, const vec_t *other)
+{
+	assert(v && other && v->type == other->type && "Type mismatch");
+	assert(other->type != TYPE_VEC && "Nested vectors can not be shared");
+
+	// Grow first: other may be v itself, whose data moves on realloc
+	size_t n = other->size;
+	vec_resize_if_needed_n(v, n);
+	memcpy((char *)v->data + v->size * vec_type_size(v->type), other->data,
+	       n * vec_type_size(v->type));
+	v->size += n;
+}
+
 /// Remove and return the last element of the vector
 void *vec_pop_back(vec_t *v)
 {
@@ -186,35 +310,135 @@ void vec_print(const vec_t *v)
 	printf("]\n");
 }
 
-vec_t *vec_copy(vec_t *v) {
-    if (!v) {
-        return NULL;
-    }
-
-    vec_t *copy = vec_create(v->type);
-    copy->size = v->size;
-    copy->cap = v->cap;
-    copy->data = malloc(vec_type_size(v->type) * v->cap);
-    assert(copy->data != NULL && "Failed to allocate memory for vector copy");
-
-    if (v->type == TYPE_VEC) {
-        // Deep copy nested vectors
-        for (size_t i = 0; i < v->size; i++) {
-            vec_t *nested_vec = (vec_t *)vec_at(v, i);
-            vec_t *nested_copy = vec_copy(nested_vec);
-            vec_push_back(copy, &nested_copy);
-        }
-    } else if (v->type == TYPE_STRING) {
-        // Deep copy strings
-        for (size_t i = 0; i < v->size; i++) {
-            char *original = *(char **)vec_at(v, i);
-            char *copy_str = strdup(original);
-            vec_push_back(copy, &copy_str);
-        }
-    } else {
-        // Shallow copy for basic types
-        memcpy(copy->data, v->data, vec_type_size(v->type) * v->size);
-    }
-
-    return copy;
+/// Deep copy src into the uninitialized struct dst, allocating exactly once
+static void vec_copy_into(vec_t *dst, const vec_t *src)
+{
+	size_t elem = vec_type_size(src->type);
+	size_t cap = src->size ? src->size : 1;
+
+	dst->data = malloc(elem * cap);
+	if (!dst->data) {
+		fprintf(stderr, "ERROR: Failed to allocate vector copy\n");
+		exit(EXIT_FAILURE);
+	}
+	dst->size = src->size;
+	dst->cap = cap;
+	dst->type = src->type;
+	dst->alloc = NULL; // Copies always live on the heap
+
+	if (src->type == TYPE_VEC) {
+		// Deep copy nested vectors straight into their inline slots
+		for (size_t i = 0; i < src->size; i++)
+			vec_copy_into((vec_t *)dst->data + i,
+				      (const vec_t *)src->data + i);
+	} else if (src->type == TYPE_STRING) {
+		// Deep copy strings
+		for (size_t i = 0; i < src->size; i++) {
+			const char *original = ((char *const *)src->data)[i];
+			char *copy_str = original ? strdup(original) : NULL;
+			if (original && !copy_str) {
+				fprintf(stderr, "ERROR: Failed to copy string\n");
+				exit(EXIT_FAILURE);
+			}
+			((char **)dst->data)[i] = copy_str;
+		}
+	} else {
+		// One bulk copy for basic types
+		memcpy(dst->data, src->data, elem * src->size);
+	}
+}
+
+/// Return a deep copy of the vector
+vec_t *vec_copy(const vec_t *v)
+{
+	if (!v)
+		return NULL;
+
+	vec_t *copy = malloc(sizeof(vec_t));
+	if (!copy) {
+		fprintf(stderr,
+			"ERROR: Failed to allocate memory for vector\n");
+		exit(EXIT_FAILURE);
+	}
+
+	vec_copy_into(copy, v);
+	return copy;
+}
+
+/// Move the storage of src into the uninitialized contents of dst, allocated
+/// through alloc; src's storage is freed and its contents left dangling.
+/// Strings are moved as pointers, nested vectors recursively.
+static void vec_transfer(vec_t *dst, vec_t *src, const vec_allocator_t *alloc)
+{
+	size_t elem = vec_type_size(src->type);
+
+	dst->data = NULL;
+	dst->size = src->size;
+	dst->cap = src->size;
+	dst->type = src->type;
+	dst->alloc = alloc;
+
+	if (src->size) {
+		dst->data = vec_mem_realloc(alloc, NULL, 0, elem * src->size);
+		if (!dst->data) {
+			fprintf(stderr, "ERROR: Failed to allocate vector\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (src->type == TYPE_VEC) {
+		for (size_t i = 0; i < src->size; i++)
+			vec_transfer((vec_t *)dst->data + i,
+				     (vec_t *)src->data + i, alloc);
+	} else if (src->size) {
+		memcpy(dst->data, src->data, elem * src->size);
+	}
+
+	vec_mem_free(src->alloc, src->data);
+}
+
+/// Steal the contents of src, releasing what dst held before
+void vec_move(vec_t *dst, vec_t *src)
+{
+	assert(dst && src);
+	if (dst == src)
+		return;
+
+	vec_release_elements(dst);
+	vec_mem_free(dst->alloc, dst->data);
+
+	if (dst->alloc == src->alloc) {
+		dst->data = src->data;
+		dst->size = src->size;
+		dst->cap = src->cap;
+		dst->type = src->type;
+	} else {
+		// Each struct keeps its allocator, so the storage is copied over
+		vec_transfer(dst, src, dst->alloc);
+	}
+
+	src->data = NULL;
+	src->size = 0;
+	src->cap = 0;
+}
+
+/// Exchange the contents of two vectors
+void vec_swap(vec_t *a, vec_t *b)
+{
+	assert(a && b);
+	if (a == b)
+		return;
+
+	if (a->alloc == b->alloc) {
+		vec_t tmp = *a;
+		*a = *b;
+		*b = tmp;
+		return;
+	}
+
+	vec_t into_a, into_b;
+	vec_transfer(&into_a, b, a->alloc);
+	vec_transfer(&into_b, a, b->alloc);
+	*a = into_a;
+	*b = into_b;
 }
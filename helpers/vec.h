@@ -12,14 +12,30 @@ typedef enum {
 	TYPE_VEC
 } vec_type_t;
 
+/// Memory source for a vector's struct and storage, see vec_create_in()
+typedef struct {
+	/// Like realloc(), and also told the current size of ptr
+	void *(*realloc)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+	void (*free)(void *ctx, void *ptr);
+	void *ctx; // Passed to both callbacks
+} vec_allocator_t;
+
 /// Structure representing a generic dynamic vector
 typedef struct {
 	void *data; // Pointer to the array of elements
 	size_t size; // Current number of elements
 	size_t cap; // Capacity of the vector
 	vec_type_t type; // Type of elements in the vector
+	const vec_allocator_t *alloc; // Where data comes from, NULL for malloc
 } vec_t;
 
+/**
+ * Growth policy: returns the new capacity for a vector that holds `cap`
+ * elements and needs room for at least `needed`. The result must be at least
+ * `needed`.
+ */
+typedef size_t (*vec_growth_fn)(size_t cap, size_t needed);
+
 /// Function declarations
 
 /**
@@ -30,6 +46,36 @@ typedef struct {
  */
 vec_t *vec_create(vec_type_t type);
 
+/**
+ * Creates a vector with room for `cap` elements, so the first `cap` pushes
+ * never reallocate.
+ *
+ * @param type The type of elements to store in the vector.
+ * @param cap Initial capacity, 0 is rounded up to 1.
+ * @return Pointer to the newly created vector.
+ */
+vec_t *vec_create_with_capacity(vec_type_t type, size_t cap);
+
+/**
+ * Creates a vector whose struct and storage come from `alloc`, and keep
+ * coming from it as the vector grows. Nested vectors pushed into it keep
+ * their own allocator.
+ *
+ * @param type The type of elements to store in the vector.
+ * @param cap Initial capacity, 0 is rounded up to 1.
+ * @param alloc The allocator, or NULL for malloc. Must outlive the vector.
+ * @return Pointer to the newly created vector.
+ */
+vec_t *vec_create_in(vec_type_t type, size_t cap, const vec_allocator_t *alloc);
+
+/**
+ * Selects how every vector grows once it runs out of capacity. The default
+ * doubles. Set it once at startup, it is not synchronized with other threads.
+ *
+ * @param growth The policy to use, or NULL to restore the default.
+ */
+void vec_set_growth(vec_growth_fn growth);
+
 /**
  * Frees the memory associated with a vector.
  *
@@ -37,6 +83,14 @@ vec_t *vec_create(vec_type_t type);
  */
 void vec_destroy(vec_t *v);
 
+/**
+ * Removes all elements but keeps the allocated capacity, so the vector can be
+ * refilled without reallocating. Nested vectors are destroyed.
+ *
+ * @param v Pointer to the vector to clear.
+ */
+void vec_clear(vec_t *v);
+
 /**
  * Returns the current number of elements in the vector.
  *
@@ -53,6 +107,23 @@ size_t vec_size(const vec_t *v);
  */
 size_t vec_capacity(const vec_t *v);
 
+/**
+ * Ensures the vector can hold at least `cap` elements without reallocating.
+ * Never shrinks.
+ *
+ * @param v Pointer to the vector.
+ * @param cap Minimum capacity.
+ */
+void vec_reserve(vec_t *v, size_t cap);
+
+/**
+ * Reduces the capacity to the current size (at least 1), returning the
+ * unused memory.
+ *
+ * @param v Pointer to the vector.
+ */
+void vec_shrink_to_fit(vec_t *v);
+
 /**
  * Accesses an element at a given index.
  *
@@ -70,6 +141,25 @@ void *vec_at(const vec_t *v, size_t index);
  */
 void vec_push_back(vec_t *v, const void *item);
 
+/**
+ * Appends `n` elements from a plain array with at most one reallocation.
+ * Elements are copied bytewise, like vec_push_back().
+ *
+ * @param v Pointer to the vector.
+ * @param items Pointer to the first of `n` elements of the vector's type.
+ * @param n Number of elements to append.
+ */
+void vec_push_n(vec_t *v, const void *items, size_t n);
+
+/**
+ * Appends all elements of another vector of the same type. Nested vectors
+ * can not be shared between parents, so `other` must not be TYPE_VEC.
+ *
+ * @param v Pointer to the vector to append to.
+ * @param other Pointer to the vector to append from.
+ */
+void vec_extend(vec_t *v, const vec_t *other);
+
 /**
  * Removes and returns the last element of the vector.
  *
@@ -105,9 +195,38 @@ void vec_print(const vec_t *v);
 /**
  * Returns a pointer to a copy of the vector
  *
+ * The copy is allocated on the heap at exactly the source size, whatever
+ * allocator the source uses. Basic types are copied with one memcpy, nested
+ * vectors are copied recursively and strings are duplicated with strdup();
+ * the duplicated strings belong to the caller, like all strings in a vec_t.
+ *
  * @param v Pointer to the vector to copy
  * @return Pointer to the copied vector
  */
-vec_t *vec_copy(vec_t *v);
+vec_t *vec_copy(const vec_t *v);
+
+/**
+ * Moves the contents of one vector into another without copying elements.
+ * Whatever `dst` held before is released, and `src` is left empty but
+ * usable (it allocates again on the next push).
+ *
+ * Each vector keeps the allocator it was created with. When the two
+ * allocators differ the elements are copied once into `dst`'s allocator,
+ * so a heap vector never ends up holding arena memory, or the reverse.
+ *
+ * @param dst Pointer to the vector receiving the contents.
+ * @param src Pointer to the vector giving them up.
+ */
+void vec_move(vec_t *dst, vec_t *src);
+
+/**
+ * Exchanges the contents of two vectors in constant time when they share an
+ * allocator. Otherwise each side's elements are copied into the other's
+ * allocator, as with vec_move().
+ *
+ * @param a Pointer to the first vector.
+ * @param b Pointer to the second vector.
+ */
+void vec_swap(vec_t *a, vec_t *b);
 
 #endif // VEC_H
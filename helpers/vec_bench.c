@@ -0,0 +1,98 @@
+#include "vec.h"
+#include "tvec.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/// Vectors of n ints, and the sum the *_at kernels read back
+typedef struct {
+	size_t n;
+	vec_t *v; // Filled by run_vec_push(), read by run_vec_at()
+	ivec_t iv; // Same for the ivec kernels
+	long long sum;
+} vec_job_t;
+
+/// Includes dropping the previous round's vector
+static void run_vec_push(void *arg)
+{
+	vec_job_t *job = arg;
+
+	vec_destroy(job->v);
+	job->v = vec_create(TYPE_INT);
+	for (size_t i = 0; i < job->n; i++) {
+		int x = (int)i;
+		vec_push_back(job->v, &x);
+	}
+}
+
+static void run_vec_at(void *arg)
+{
+	vec_job_t *job = arg;
+	long long s = 0;
+
+	for (size_t i = 0; i < job->n; i++)
+		s += *(int *)vec_at(job->v, i);
+	job->sum = s;
+}
+
+/// Includes dropping the previous round's vector
+static void run_ivec_push(void *arg)
+{
+	vec_job_t *job = arg;
+
+	ivec_free(&job->iv);
+	for (size_t i = 0; i < job->n; i++)
+		ivec_push(&job->iv, (int)i);
+}
+
+static void run_ivec_at(void *arg)
+{
+	vec_job_t *job = arg;
+	long long s = 0;
+
+	for (size_t i = 0; i < job->n; i++)
+		s += *ivec_at(&job->iv, i);
+	job->sum = s;
+}
+
+/// Copy is one allocation and one memcpy
+static void run_vec_copy(void *arg)
+{
+	vec_job_t *job = arg;
+	vec_t *dup = vec_copy(job->v);
+
+	job->sum = vec_size(dup);
+	vec_destroy(dup);
+}
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) :
+			      bench_scaled(50000000);
+	size_t bytes = n * sizeof(int);
+	vec_job_t job = { 0 };
+
+	job.n = n;
+
+	double t_vec_push = bench_run("vec/vec_t/push", bytes, run_vec_push, &job);
+	double t_ivec_push =
+		bench_run("vec/ivec/push", bytes, run_ivec_push, &job);
+	double t_vec_at = bench_run("vec/vec_t/at", bytes, run_vec_at, &job);
+	long long vec_sum = job.sum;
+	double t_ivec_at = bench_run("vec/ivec/at", bytes, run_ivec_at, &job);
+	long long ivec_sum = job.sum;
+
+	if (vec_sum != ivec_sum) {
+		fprintf(stderr, "ERROR: ivec sum %lld, vec_t sum %lld\n",
+			ivec_sum, vec_sum);
+		return 1;
+	}
+
+	bench_run("vec/vec_t/copy", bytes, run_vec_copy, &job);
+	bench_note("%-28s push %.1fx, at %.1fx faster than vec_t", "ivec",
+		   t_vec_push / t_ivec_push, t_vec_at / t_ivec_at);
+
+	vec_destroy(job.v);
+	ivec_free(&job.iv);
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include "vec_pool.h"
+#include <assert.h>
+#include <stdlib.h>
+
+void vec_pool_init(vec_pool_t *p, vec_type_t type)
+{
+	assert(type != TYPE_VEC && "Pooled children must not nest");
+	p->free_rows = vec_create(TYPE_VEC);
+	p->type = type;
+	p->created = 0;
+	p->reused = 0;
+}
+
+void vec_pool_free(vec_pool_t *p)
+{
+	if (!p)
+		return;
+
+	vec_destroy(p->free_rows); // Frees the retained child storage as well
+	p->free_rows = NULL;
+}
+
+/// Take a cleared child off the free list, or allocate a fresh one
+static void vec_pool_take(vec_pool_t *p, vec_t *child)
+{
+	if (vec_size(p->free_rows)) {
+		*child = *(vec_t *)vec_pop_back(p->free_rows);
+		child->size = 0;
+		p->reused++;
+		return;
+	}
+
+	vec_t *fresh = vec_create(p->type);
+	*child = *fresh;
+	free(fresh); // The struct lives inline in the parent from now on
+	p->created++;
+}
+
+vec_t *vec_pool_push_row(vec_pool_t *p, vec_t *parent)
+{
+	assert(p && parent && parent->type == TYPE_VEC);
+
+	vec_t child;
+	vec_pool_take(p, &child);
+	vec_push_back(parent, &child);
+	return vec_at(parent, vec_size(parent) - 1);
+}
+
+void vec_pool_clear(vec_pool_t *p, vec_t *parent)
+{
+	assert(p && parent && parent->type == TYPE_VEC);
+
+	// Last row first, so the next fill gets row i's buffer back for row i
+	vec_reserve(p->free_rows, vec_size(p->free_rows) + parent->size);
+	for (size_t i = parent->size; i-- > 0;)
+		vec_push_back(p->free_rows, vec_at(parent, i));
+	parent->size = 0;
+}
+
+vec_t *vec_pool_copy(vec_pool_t *p, const vec_t *parent)
+{
+	assert(p && parent && parent->type == TYPE_VEC);
+
+	vec_t *copy = vec_create_with_capacity(TYPE_VEC, parent->size);
+
+	for (size_t i = 0; i < parent->size; i++) {
+		const vec_t *src = vec_at(parent, i);
+		vec_t *dst = vec_pool_push_row(p, copy);
+
+		assert(src->type == p->type && "Child type differs from the pool");
+		vec_push_n(dst, src->data, src->size);
+	}
+
+	return copy;
+}
@@ -0,0 +1,61 @@
+#ifndef VEC_POOL_H
+#define VEC_POOL_H
+
+#include <stddef.h> // For size_t
+#include "vec.h"
+
+/// Free list of child vectors that keep their capacity between uses
+typedef struct {
+	vec_t *free_rows; // TYPE_VEC holding the recycled children inline
+	vec_type_t type; // Element type of every pooled child
+	size_t created; // Children that had to be allocated
+	size_t reused; // Children handed out from the free list
+} vec_pool_t;
+
+/**
+ * Initializes an empty pool of child vectors of one element type.
+ *
+ * @param p Pointer to the pool.
+ * @param type Element type of the children, must not be TYPE_VEC.
+ */
+void vec_pool_init(vec_pool_t *p, vec_type_t type);
+
+/**
+ * Frees the pool and every child still on its free list. Children handed
+ * out and not given back stay owned by their parent.
+ *
+ * @param p Pointer to the pool.
+ */
+void vec_pool_free(vec_pool_t *p);
+
+/**
+ * Appends an empty child to a TYPE_VEC parent, recycled from the pool when
+ * one is available, and returns it for filling in place.
+ *
+ * @param p Pointer to the pool.
+ * @param parent TYPE_VEC vector to append to.
+ * @return Pointer to the new child, valid until the parent grows again.
+ */
+vec_t *vec_pool_push_row(vec_pool_t *p, vec_t *parent);
+
+/**
+ * Empties a TYPE_VEC parent, moving all its children to the pool with their
+ * capacity intact. The parent keeps its own capacity too.
+ *
+ * @param p Pointer to the pool.
+ * @param parent TYPE_VEC vector whose children came from this pool.
+ */
+void vec_pool_clear(vec_pool_t *p, vec_t *parent);
+
+/**
+ * Deep copies a TYPE_VEC parent, taking the children of the copy from the
+ * pool. Each child gets one bulk copy of the source child's elements.
+ *
+ * @param p Pointer to the pool.
+ * @param parent TYPE_VEC vector to copy.
+ * @return The copy, give its children back with vec_pool_clear() before
+ * destroying it.
+ */
+vec_t *vec_pool_copy(vec_pool_t *p, const vec_t *parent);
+
+#endif // VEC_POOL_H
@@ -0,0 +1,66 @@
+#include "vec_pool.h"
+#include "vec.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/// One build of `rows` report-sized children into parent
+static void build(vec_pool_t *p, vec_t *parent, size_t rows)
+{
+	for (size_t r = 0; r < rows; r++) {
+		vec_t *row;
+
+		if (p) {
+			row = vec_pool_push_row(p, parent);
+		} else {
+			vec_t *fresh = vec_create(TYPE_INT);
+			vec_push_back(parent, fresh);
+			free(fresh);
+			row = vec_at(parent, vec_size(parent) - 1);
+		}
+
+		for (int i = 0; i < 5 + (int)(r % 4); i++)
+			vec_push_back(row, &i);
+	}
+}
+
+/// One build and release of every row, from the heap or a pool
+typedef struct {
+	vec_pool_t *pool; // NULL: the heap
+	vec_t *parent;
+	size_t rows;
+} pool_job_t;
+
+static void run_cycle(void *arg)
+{
+	pool_job_t *job = arg;
+
+	build(job->pool, job->parent, job->rows);
+	if (job->pool)
+		vec_pool_clear(job->pool, job->parent);
+	else
+		vec_clear(job->parent);
+}
+
+int main(int argc, char **argv)
+{
+	size_t rows = argc > 1 ? strtoul(argv[1], NULL, 10) :
+				 bench_scaled(1000000);
+	vec_t *parent = vec_create_with_capacity(TYPE_VEC, rows);
+	vec_pool_t pool;
+
+	vec_pool_init(&pool, TYPE_INT);
+
+	// The warmup round fills the pool, timed rounds then only reuse
+	pool_job_t heap = { NULL, parent, rows };
+	pool_job_t pooled = { &pool, parent, rows };
+	double t_heap = bench_run("vec_pool/heap", 0, run_cycle, &heap);
+	double t_pooled = bench_run("vec_pool/pooled", 0, run_cycle, &pooled);
+
+	bench_note("%-28s %zu created, %zu reused, %.1fx faster", "vec_pool",
+		   pool.created, pool.reused, t_heap / t_pooled);
+
+	vec_destroy(parent);
+	vec_pool_free(&pool);
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include "vec_pool.h"
+#include "vec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/// Append rows of 0..len-1 for every len in lens
+static void fill_rows(vec_pool_t *p, vec_t *parent, const size_t *lens,
+		      size_t n)
+{
+	for (size_t r = 0; r < n; r++) {
+		vec_t *row = vec_pool_push_row(p, parent);
+		assert(vec_size(row) == 0);
+		for (int i = 0; i < (int)lens[r]; i++)
+			vec_push_back(row, &i);
+	}
+}
+
+void test_reuse(void)
+{
+	vec_pool_t p;
+	vec_t *rows = vec_create(TYPE_VEC);
+	size_t lens[] = { 3, 40, 7, 100 };
+
+	vec_pool_init(&p, TYPE_INT);
+
+	fill_rows(&p, rows, lens, 4);
+	assert(p.created == 4 && p.reused == 0);
+
+	void *data[4];
+	size_t caps[4];
+	for (size_t r = 0; r < 4; r++) {
+		data[r] = ((vec_t *)vec_at(rows, r))->data;
+		caps[r] = vec_capacity(vec_at(rows, r));
+	}
+
+	for (int cycle = 0; cycle < 1000; cycle++) {
+		vec_pool_clear(&p, rows);
+		assert(vec_size(rows) == 0);
+		fill_rows(&p, rows, lens, 4);
+	}
+
+	// Nothing allocated after the first cycle, each row got its buffer back
+	assert(p.created == 4 && p.reused == 4000);
+	for (size_t r = 0; r < 4; r++) {
+		vec_t *row = vec_at(rows, r);
+		assert(row->data == data[r] && row->cap == caps[r]);
+		assert(vec_size(row) == lens[r]);
+		assert(*(int *)vec_at(row, lens[r] - 1) == (int)lens[r] - 1);
+	}
+
+	vec_pool_clear(&p, rows);
+	vec_destroy(rows);
+	vec_pool_free(&p);
+	printf("test_reuse passed.\n");
+}
+
+void test_deep_copy(void)
+{
+	vec_pool_t p;
+	vec_t *rows = vec_create(TYPE_VEC);
+	size_t lens[] = { 5, 0, 9 };
+
+	vec_pool_init(&p, TYPE_INT);
+	fill_rows(&p, rows, lens, 3);
+
+	vec_t *copy = vec_pool_copy(&p, rows);
+	assert(vec_size(copy) == 3);
+
+	for (size_t r = 0; r < 3; r++) {
+		vec_t *src = vec_at(rows, r);
+		vec_t *dst = vec_at(copy, r);
+		assert(vec_size(dst) == lens[r]);
+		assert(lens[r] == 0 || dst->data != src->data);
+		for (size_t i = 0; i < lens[r]; i++)
+			assert(*(int *)vec_at(dst, i) == *(int *)vec_at(src, i));
+	}
+
+	// Changing the copy leaves the original alone
+	int x = -1;
+	*(int *)vec_at(vec_at(copy, 0), 0) = x;
+	vec_push_back(vec_at(copy, 2), &x);
+	assert(*(int *)vec_at(vec_at(rows, 0), 0) == 0);
+	assert(vec_size(vec_at(rows, 2)) == 9);
+
+	// Copies recycle too: the original's rows feed the next copy
+	vec_pool_clear(&p, rows);
+	vec_t *again = vec_pool_copy(&p, copy);
+	assert(p.reused == 3);
+	assert(*(int *)vec_at(vec_at(again, 2), 9) == -1);
+
+	vec_pool_clear(&p, copy);
+	vec_pool_clear(&p, again);
+	vec_destroy(rows);
+	vec_destroy(copy);
+	vec_destroy(again);
+	vec_pool_free(&p);
+	printf("test_deep_copy passed.\n");
+}
+
+void test_destroy_without_pool(void)
+{
+	vec_pool_t p;
+	vec_t *rows = vec_create(TYPE_VEC);
+	size_t lens[] = { 4, 4 };
+
+	vec_pool_init(&p, TYPE_INT);
+	fill_rows(&p, rows, lens, 2);
+
+	// Rows never given back are still freed by their parent
+	vec_destroy(rows);
+	vec_pool_free(&p);
+	printf("test_destroy_without_pool passed.\n");
+}
+
+int main(void)
+{
+	test_reuse();
+	test_deep_copy();
+	test_destroy_without_pool();
+
+	printf("All tests passed.\n");
+	return 0;
+}
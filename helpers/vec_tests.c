@@ -1,4 +1,5 @@
 #include "vec.h"
+#include "tvec.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -92,6 +93,10 @@ void test_nested_vectors(void)
 	vec_push_back(outer, inner1);
 	vec_push_back(outer, inner2);
 
+	// outer now owns the contents, only the structs were copied
+	free(inner1);
+	free(inner2);
+
 	vec_t *retrieved_inner1 = (vec_t *)vec_at(outer, 0);
 	vec_t *retrieved_inner2 = (vec_t *)vec_at(outer, 1);
 
@@ -135,11 +140,221 @@ void test_copy(void)
 		assert(*(int *)vec_at(copy, i) == *(int *)vec_at(v, i));
 	}
 
+	assert(vec_capacity(copy) == 3 && copy->data != v->data);
+
 	vec_destroy(v);
 	vec_destroy(copy);
 	printf("test_copy passed.\n");
 }
 
+void test_copy_deep(void)
+{
+	vec_t *outer = vec_create(TYPE_VEC);
+	int nums[] = { 1, 2, 3, 4 };
+
+	for (size_t r = 0; r < 3; r++) {
+		vec_t *inner = vec_create(TYPE_INT);
+		vec_push_n(inner, nums, r + 1);
+		vec_push_back(outer, inner);
+		free(inner);
+	}
+
+	vec_t *copy = vec_copy(outer);
+	assert(vec_size(copy) == 3 && vec_capacity(copy) == 3);
+	for (size_t r = 0; r < 3; r++) {
+		vec_t *src = vec_at(outer, r), *dst = vec_at(copy, r);
+		assert(vec_size(dst) == r + 1 && dst->data != src->data);
+		assert(*(int *)vec_at(dst, r) == nums[r]);
+	}
+
+	// The copy is independent of the source
+	*(int *)vec_at(vec_at(copy, 0), 0) = 42;
+	assert(*(int *)vec_at(vec_at(outer, 0), 0) == 1);
+
+	vec_t *strings = vec_create(TYPE_STRING);
+	const char *words[] = { "apple", "banana" };
+	vec_push_n(strings, words, 2);
+
+	vec_t *strings_copy = vec_copy(strings);
+	assert(vec_size(strings_copy) == 2);
+	for (size_t i = 0; i < 2; i++) {
+		char *s = *(char **)vec_at(strings_copy, i);
+		assert(s != words[i] && strcmp(s, words[i]) == 0);
+		free(s); // Duplicated strings belong to the caller
+	}
+
+	// Empty vectors copy to an empty vector
+	vec_t *empty = vec_create(TYPE_FLOAT);
+	vec_t *empty_copy = vec_copy(empty);
+	assert(vec_size(empty_copy) == 0 && empty_copy->type == TYPE_FLOAT);
+
+	vec_destroy(outer);
+	vec_destroy(copy);
+	vec_destroy(strings);
+	vec_destroy(strings_copy);
+	vec_destroy(empty);
+	vec_destroy(empty_copy);
+	printf("test_copy_deep passed.\n");
+}
+
+void test_move_swap(void)
+{
+	vec_t *a = vec_create(TYPE_INT);
+	vec_t *b = vec_create(TYPE_INT);
+	int nums[] = { 1, 2, 3, 4, 5 };
+
+	vec_push_n(a, nums, 5);
+	vec_push_n(b, nums, 2);
+
+	void *a_data = a->data;
+	vec_swap(a, b);
+	assert(vec_size(a) == 2 && vec_size(b) == 5 && b->data == a_data);
+
+	vec_move(a, b); // a's old contents are released
+	assert(vec_size(a) == 5 && a->data == a_data);
+	assert(vec_size(b) == 0 && b->data == NULL);
+
+	// A moved-from vector is still usable
+	vec_push_back(b, &nums[4]);
+	assert(vec_size(b) == 1 && *(int *)vec_at(b, 0) == 5);
+
+	vec_move(a, a);
+	assert(vec_size(a) == 5);
+
+	vec_destroy(a);
+	vec_destroy(b);
+	printf("test_move_swap passed.\n");
+}
+
+void test_clear(void)
+{
+	vec_t *v = vec_create(TYPE_INT);
+	int nums[] = { 10, 20, 30, 40, 50, 60, 70, 80, 90 };
+
+	for (size_t i = 0; i < 9; i++)
+		vec_push_back(v, &nums[i]);
+
+	size_t cap = vec_capacity(v);
+	vec_clear(v);
+	assert(vec_size(v) == 0);
+	assert(vec_capacity(v) == cap);
+
+	vec_push_back(v, &nums[8]);
+	assert(vec_size(v) == 1);
+	assert(*(int *)vec_at(v, 0) == 90);
+
+	vec_destroy(v);
+	printf("test_clear passed.\n");
+}
+
+void test_reserve_shrink(void)
+{
+	vec_t *v = vec_create_with_capacity(TYPE_INT, 100);
+	assert(vec_capacity(v) == 100);
+
+	int *before = v->data;
+	for (int i = 0; i < 100; i++)
+		vec_push_back(v, &i);
+	assert(v->data == before && "Reallocated within the reserved capacity");
+
+	vec_reserve(v, 50); // Never shrinks
+	assert(vec_capacity(v) == 100);
+	vec_reserve(v, 1000);
+	assert(vec_capacity(v) == 1000);
+	assert(*(int *)vec_at(v, 99) == 99);
+
+	vec_shrink_to_fit(v);
+	assert(vec_capacity(v) == 100 && vec_size(v) == 100);
+
+	vec_clear(v);
+	vec_shrink_to_fit(v);
+	assert(vec_capacity(v) == 1);
+
+	vec_destroy(v);
+	printf("test_reserve_shrink passed.\n");
+}
+
+void test_push_n_extend(void)
+{
+	vec_t *v = vec_create(TYPE_INT);
+	int nums[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+
+	vec_push_n(v, nums, 12);
+	assert(vec_size(v) == 12);
+	vec_push_n(v, NULL, 0);
+	assert(vec_size(v) == 12);
+
+	vec_t *other = vec_create(TYPE_INT);
+	vec_push_n(other, nums, 3);
+	vec_extend(v, other);
+	assert(vec_size(v) == 15 && *(int *)vec_at(v, 14) == 3);
+
+	vec_extend(v, v); // Appending to itself doubles the contents
+	assert(vec_size(v) == 30);
+	for (size_t i = 0; i < 15; i++)
+		assert(*(int *)vec_at(v, i) == *(int *)vec_at(v, i + 15));
+
+	vec_destroy(other);
+	vec_destroy(v);
+	printf("test_push_n_extend passed.\n");
+}
+
+/// Grows by 1.5x instead of doubling
+static size_t grow_by_half(size_t cap, size_t needed)
+{
+	size_t new_cap = cap + cap / 2 + 1;
+	return new_cap < needed ? needed : new_cap;
+}
+
+void test_growth(void)
+{
+	vec_set_growth(grow_by_half);
+
+	vec_t *v = vec_create_with_capacity(TYPE_INT, 10);
+	for (int i = 0; i < 11; i++)
+		vec_push_back(v, &i);
+	assert(vec_capacity(v) == 16);
+	vec_destroy(v);
+
+	vec_set_growth(NULL);
+	v = vec_create_with_capacity(TYPE_INT, 10);
+	for (int i = 0; i < 11; i++)
+		vec_push_back(v, &i);
+	assert(vec_capacity(v) == 20);
+	vec_destroy(v);
+
+	printf("test_growth passed.\n");
+}
+
+void test_tvec(void)
+{
+	ivec_t v = { 0 };
+
+	for (int i = 0; i < 100; i++)
+		ivec_push(&v, i * 10);
+
+	assert(ivec_size(&v) == 100);
+	assert(v.cap >= 100);
+	for (size_t i = 0; i < 100; i++)
+		assert(*ivec_at(&v, i) == (int)i * 10);
+
+	assert(ivec_pop(&v) == 990);
+	assert(ivec_size(&v) == 99);
+
+	size_t cap = v.cap;
+	ivec_clear(&v);
+	assert(ivec_size(&v) == 0 && v.cap == cap);
+
+	ivec_reserve(&v, 1000);
+	assert(v.cap == 1000);
+	ivec_push(&v, 7);
+	assert(*ivec_at(&v, 0) == 7);
+
+	ivec_free(&v);
+	assert(v.data == NULL && ivec_size(&v) == 0);
+	printf("test_tvec passed.\n");
+}
+
 int main(void)
 {
 	test_create_destroy();
@@ -149,6 +364,13 @@ int main(void)
 	test_nested_vectors();
 	test_print();
 	test_copy();
+	test_copy_deep();
+	test_move_swap();
+	test_clear();
+	test_reserve_shrink();
+	test_push_n_extend();
+	test_growth();
+	test_tvec();
 
 	printf("All tests passed.\n");
 	return 0;